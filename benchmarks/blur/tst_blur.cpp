@@ -0,0 +1,468 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfileinfo.h>
+#include <QtGui/qbrush.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qimagereader.h>
+#include <QtGui/qpainter.h>
+#include <QtTest/qtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/*
+ * Conformance and throughput harness for the blur used by the Mica material.
+ *
+ * Every blur variant is compared against a straightforward floating point
+ * implementation of the same pipeline (2x downscale, two sided exponential blur
+ * over the rows and then the columns, 2x bilinear upscale), which has no
+ * rounding or truncation at all. Optionally, it's also compared against
+ * golden images saved from a previous run, so a new kernel can be checked
+ * against the output of the one it replaces.
+ *
+ * Environment variables:
+ *   FRAMELESSHELPER_BLUR_WALLPAPERS: a directory with real wallpapers to test, in
+ *     addition to the synthetic images.
+ *   FRAMELESSHELPER_BLUR_GOLDEN_DIR: a directory with the golden images.
+ *   FRAMELESSHELPER_BLUR_UPDATE_GOLDEN: write the output of the first variant into
+ *     the golden directory instead of comparing against it.
+ */
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+FRAMELESSHELPER_BYTEARRAY_CONSTANT2(WallpapersVar, "FRAMELESSHELPER_BLUR_WALLPAPERS")
+FRAMELESSHELPER_BYTEARRAY_CONSTANT2(GoldenDirVar, "FRAMELESSHELPER_BLUR_GOLDEN_DIR")
+FRAMELESSHELPER_BYTEARRAY_CONSTANT2(UpdateGoldenVar, "FRAMELESSHELPER_BLUR_UPDATE_GOLDEN")
+
+static constexpr const QSize kMaximumPictureSize = {1920, 1080};
+static constexpr const QImage::Format kImageFormat = QImage::Format_ARGB32_Premultiplied;
+static constexpr const qreal kDefaultBlurRadius = 128.0;
+
+// The current fixed point kernel truncates after every pass, which makes its output
+// up to a few levels darker than the exact result, but the error is spread evenly.
+// Banding shows up as large localized errors, which is what the max error catches.
+static constexpr const double kMinimumPsnr = 35.0;
+static constexpr const int kMaximumError = 10;
+
+// How long each variant is run for to measure its throughput.
+static constexpr const qint64 kThroughputDuration = 300;
+static constexpr const int kThroughputMinimumRuns = 3;
+
+using BlurFunction = QImage(*)(const QImage &, const qreal);
+
+struct BlurVariant
+{
+    const char *name = nullptr;
+    BlurFunction function = nullptr;
+};
+
+[[nodiscard]] static QImage referenceBlur(const QImage &source, const qreal radius);
+
+// Add new kernels here, all of them go through the same checks and measurements.
+static const BlurVariant kBlurVariants[] = {
+    {"reference", &referenceBlur},
+    {"expblur", &MicaMaterialPrivate::blurImage}
+};
+
+struct Comparison
+{
+    double psnr = 0.0;
+    int maximumError = 0;
+};
+
+struct TestImage
+{
+    QString name = {};
+    QImage image = {};
+};
+
+class FloatImage
+{
+public:
+    explicit FloatImage(const QSize &size) : m_width(size.width()), m_height(size.height()),
+        m_data(std::size_t(size.width()) * std::size_t(size.height()) * 4, 0.0) {}
+
+    explicit FloatImage(const QImage &image) : FloatImage(image.size())
+    {
+        const QImage source = image.convertToFormat(kImageFormat);
+        for (int y = 0; y != m_height; ++y) {
+            const auto line = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+            for (int x = 0; x != m_width; ++x) {
+                double * const pixel = at(x, y);
+                pixel[0] = qRed(line[x]);
+                pixel[1] = qGreen(line[x]);
+                pixel[2] = qBlue(line[x]);
+                pixel[3] = qAlpha(line[x]);
+            }
+        }
+    }
+
+    [[nodiscard]] int width() const { return m_width; }
+    [[nodiscard]] int height() const { return m_height; }
+
+    [[nodiscard]] double *at(const int x, const int y)
+    {
+        return &m_data[((std::size_t(y) * std::size_t(m_width)) + std::size_t(x)) * 4];
+    }
+
+    [[nodiscard]] const double *at(const int x, const int y) const
+    {
+        return &m_data[((std::size_t(y) * std::size_t(m_width)) + std::size_t(x)) * 4];
+    }
+
+    // Two sided exponential blur of one row or column, the second pass runs on
+    // the output of the first one and continues from its state, just like expblur.
+    void blurLine(const int start, const int count, const int step, const double alpha)
+    {
+        double * const base = &m_data[std::size_t(start) * 4];
+        for (int channel = 0; channel != 4; ++channel) {
+            double z = 0.0;
+            for (int index = 0; index != count; ++index) {
+                double &value = base[(std::size_t(index) * std::size_t(step) * 4) + std::size_t(channel)];
+                z += (alpha * (value - z));
+                value = z;
+            }
+            for (int index = (count - 2); index >= 0; --index) {
+                double &value = base[(std::size_t(index) * std::size_t(step) * 4) + std::size_t(channel)];
+                z += (alpha * (value - z));
+                value = z;
+            }
+        }
+    }
+
+    // Same sample positions as QPainter's smooth transform for a 2x upscale: the
+    // centers of the destination pixels, with the edge pixels repeated.
+    [[nodiscard]] double sampleDoubled(const int x, const int y, const int channel) const
+    {
+        const double sourceX = (((double(x) + 0.5) / 2.0) - 0.5);
+        const double sourceY = (((double(y) + 0.5) / 2.0) - 0.5);
+        const int x0 = int(std::floor(sourceX));
+        const int y0 = int(std::floor(sourceY));
+        const double tx = (sourceX - double(x0));
+        const double ty = (sourceY - double(y0));
+        const auto value = [this, channel](const int px, const int py) -> double {
+            return at(qBound(0, px, (m_width - 1)), qBound(0, py, (m_height - 1)))[channel];
+        };
+        const double top = ((value(x0, y0) * (1.0 - tx)) + (value((x0 + 1), y0) * tx));
+        const double bottom = ((value(x0, (y0 + 1)) * (1.0 - tx)) + (value((x0 + 1), (y0 + 1)) * tx));
+        return ((top * (1.0 - ty)) + (bottom * ty));
+    }
+
+    [[nodiscard]] FloatImage halfScaled() const
+    {
+        FloatImage result(QSize((m_width / 2), (m_height / 2)));
+        for (int y = 0; y != result.height(); ++y) {
+            for (int x = 0; x != result.width(); ++x) {
+                double * const pixel = result.at(x, y);
+                const double *p1 = at((x * 2), (y * 2));
+                const double *p2 = at((x * 2), ((y * 2) + 1));
+                for (int channel = 0; channel != 4; ++channel) {
+                    pixel[channel] = ((p1[channel] + p1[channel + 4] + p2[channel] + p2[channel + 4]) / 4.0);
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<double> m_data = {};
+};
+
+QImage referenceBlur(const QImage &source, const qreal radius)
+{
+    FloatImage image(source);
+    int scale = 1;
+    qreal realRadius = radius;
+    if ((realRadius >= 4) && (image.width() >= 2) && (image.height() >= 2)) {
+        image = image.halfScaled();
+        scale = 2;
+        realRadius *= 0.5;
+    }
+    const double alpha = ((realRadius <= qreal(1e-5)) ? 1.0 :
+        (1.0 - std::pow((2.0 / 255.0), (1.0 / realRadius))));
+    for (int y = 0; y != image.height(); ++y) {
+        image.blurLine((y * image.width()), image.width(), 1, alpha);
+    }
+    for (int x = 0; x != image.width(); ++x) {
+        image.blurLine(x, image.height(), image.width(), alpha);
+    }
+    QImage result(source.size(), kImageFormat);
+    result.fill(Qt::transparent);
+    const int width = qMin(result.width(), (image.width() * scale));
+    const int height = qMin(result.height(), (image.height() * scale));
+    const auto toChannel = [](const double value) -> int {
+        return qBound(0, int(std::lround(value)), 255);
+    };
+    for (int y = 0; y != height; ++y) {
+        const auto line = reinterpret_cast<QRgb *>(result.scanLine(y));
+        for (int x = 0; x != width; ++x) {
+            if (scale == 1) {
+                const double * const pixel = image.at(x, y);
+                line[x] = qRgba(toChannel(pixel[0]), toChannel(pixel[1]), toChannel(pixel[2]), toChannel(pixel[3]));
+                continue;
+            }
+            line[x] = qRgba(toChannel(image.sampleDoubled(x, y, 0)), toChannel(image.sampleDoubled(x, y, 1)),
+                toChannel(image.sampleDoubled(x, y, 2)), toChannel(image.sampleDoubled(x, y, 3)));
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] static inline Comparison compareImages(const QImage &actual, const QImage &expected)
+{
+    Q_ASSERT(actual.size() == expected.size());
+    const QImage lhs = actual.convertToFormat(kImageFormat);
+    const QImage rhs = expected.convertToFormat(kImageFormat);
+    double squaredError = 0.0;
+    int maximumError = 0;
+    for (int y = 0; y != lhs.height(); ++y) {
+        const auto lhsLine = reinterpret_cast<const QRgb *>(lhs.constScanLine(y));
+        const auto rhsLine = reinterpret_cast<const QRgb *>(rhs.constScanLine(y));
+        for (int x = 0; x != lhs.width(); ++x) {
+            const int errors[] = {
+                (qRed(lhsLine[x]) - qRed(rhsLine[x])),
+                (qGreen(lhsLine[x]) - qGreen(rhsLine[x])),
+                (qBlue(lhsLine[x]) - qBlue(rhsLine[x])),
+                (qAlpha(lhsLine[x]) - qAlpha(rhsLine[x]))
+            };
+            for (auto &&error : errors) {
+                squaredError += (double(error) * double(error));
+                maximumError = qMax(maximumError, std::abs(error));
+            }
+        }
+    }
+    const double meanSquaredError = (squaredError / (double(lhs.width()) * double(lhs.height()) * 4.0));
+    Comparison result = {};
+    result.maximumError = maximumError;
+    result.psnr = (qFuzzyIsNull(meanSquaredError) ? std::numeric_limits<double>::infinity() :
+        (10.0 * std::log10((255.0 * 255.0) / meanSquaredError)));
+    return result;
+}
+
+// Megapixels per second.
+[[nodiscard]] static inline double measureThroughput(const BlurFunction function, const QImage &image, const qreal radius)
+{
+    QElapsedTimer timer;
+    int runs = 0;
+    timer.start();
+    while ((runs < kThroughputMinimumRuns) || (timer.elapsed() < kThroughputDuration)) {
+        const QImage result = function(image, radius);
+        Q_UNUSED(result);
+        ++runs;
+    }
+    const double seconds = (double(timer.nsecsElapsed()) / 1e9);
+    const double megapixels = ((double(image.width()) * double(image.height()) * double(runs)) / 1e6);
+    return (megapixels / seconds);
+}
+
+[[nodiscard]] static inline QImage createGradientImage(const QSize &size)
+{
+    // Large smooth gradients are where banding is the most visible.
+    QImage image(size, kImageFormat);
+    QPainter painter(&image);
+    QLinearGradient gradient(QPointF(0, 0), QPointF(size.width(), size.height()));
+    gradient.setColorAt(0.0, QColor(20, 40, 90));
+    gradient.setColorAt(0.5, QColor(60, 110, 170));
+    gradient.setColorAt(1.0, QColor(230, 200, 150));
+    painter.fillRect(image.rect(), gradient);
+    painter.end();
+    return image;
+}
+
+[[nodiscard]] static inline QImage createCheckerImage(const QSize &size)
+{
+    // Hard, high contrast edges.
+    QImage image(size, kImageFormat);
+    QPainter painter(&image);
+    static constexpr const int cellSize = 64;
+    for (int y = 0; y < size.height(); y += cellSize) {
+        for (int x = 0; x < size.width(); x += cellSize) {
+            const bool dark = (((x / cellSize) + (y / cellSize)) % 2);
+            painter.fillRect(QRect(x, y, cellSize, cellSize), (dark ? QColor(16, 16, 16) : QColor(240, 240, 240)));
+        }
+    }
+    painter.end();
+    return image;
+}
+
+[[nodiscard]] static inline QImage createNoiseImage(const QSize &size)
+{
+    // Deterministic white noise, the worst case for the rounding errors.
+    QImage image(size, kImageFormat);
+    quint32 state = 0x12345678U;
+    for (int y = 0; y != size.height(); ++y) {
+        const auto line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x != size.width(); ++x) {
+            state ^= (state << 13);
+            state ^= (state >> 17);
+            state ^= (state << 5);
+            line[x] = qRgb(int(state & 0xFF), int((state >> 8) & 0xFF), int((state >> 16) & 0xFF));
+        }
+    }
+    return image;
+}
+
+[[nodiscard]] static inline QImage createFlatImage(const QSize &size)
+{
+    QImage image(size, kImageFormat);
+    image.fill(QColor(128, 64, 192));
+    return image;
+}
+
+[[nodiscard]] static inline QList<TestImage> testImages()
+{
+    QList<TestImage> images = {
+        {QStringLiteral("gradient-1920x1080"), createGradientImage(QSize(1920, 1080))},
+        {QStringLiteral("checker-1920x1080"), createCheckerImage(QSize(1920, 1080))},
+        {QStringLiteral("noise-1280x720"), createNoiseImage(QSize(1280, 720))},
+        {QStringLiteral("flat-255x255"), createFlatImage(QSize(255, 255))}
+    };
+    const QString wallpaperDir = qEnvironmentVariable(kWallpapersVar);
+    if (!wallpaperDir.isEmpty()) {
+        const QDir dir(wallpaperDir);
+        const QFileInfoList files = dir.entryInfoList(QDir::Files, QDir::Name);
+        for (auto &&file : std::as_const(files)) {
+            QImageReader reader(file.absoluteFilePath());
+            if (!reader.canRead()) {
+                continue;
+            }
+            QImage image = reader.read();
+            if (image.isNull()) {
+                continue;
+            }
+            // Same as what the wallpaper thread does.
+            if ((image.width() > kMaximumPictureSize.width()) || (image.height() > kMaximumPictureSize.height())) {
+                image = image.scaled(kMaximumPictureSize, Qt::KeepAspectRatio, Qt::FastTransformation);
+            }
+            images.append({(QStringLiteral("wallpaper-") + file.completeBaseName()), image.convertToFormat(kImageFormat)});
+        }
+    }
+    return images;
+}
+
+class BlurConformance : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+#ifdef FRAMELESSHELPER_CORE_NO_PRIVATE
+        QSKIP("The blur is not available without the private Qt headers.");
+#endif
+        m_images = testImages();
+        m_goldenDir = qEnvironmentVariable(kGoldenDirVar);
+        m_updateGolden = qEnvironmentVariableIsSet(kUpdateGoldenVar);
+        if (m_updateGolden) {
+            QVERIFY2(!m_goldenDir.isEmpty(), "Nowhere to save the golden images.");
+            QVERIFY(QDir().mkpath(m_goldenDir));
+        }
+    }
+
+    void conformance_data()
+    {
+        QTest::addColumn<int>("variant");
+        QTest::addColumn<int>("image");
+        QTest::addColumn<qreal>("radius");
+        for (int variant = 0; variant != int(std::size(kBlurVariants)); ++variant) {
+            for (int image = 0; image != m_images.size(); ++image) {
+                for (auto &&radius : {qreal(16), kDefaultBlurRadius}) {
+                    const QByteArray name = (QByteArray(kBlurVariants[variant].name) + ' '
+                        + m_images.at(image).name.toUtf8() + " r=" + QByteArray::number(radius));
+                    QTest::newRow(name.constData()) << variant << image << radius;
+                }
+            }
+        }
+    }
+
+    void conformance()
+    {
+        QFETCH(const int, variant);
+        QFETCH(const int, image);
+        QFETCH(const qreal, radius);
+        const BlurVariant &blur = kBlurVariants[variant];
+        const TestImage &source = m_images.at(image);
+        const QImage expected = referenceBlur(source.image, radius);
+        const QImage actual = blur.function(source.image, radius);
+        QCOMPARE(actual.size(), source.image.size());
+        const Comparison reference = compareImages(actual, expected);
+        const double throughput = measureThroughput(blur.function, source.image, radius);
+        qInfo("%s %s r=%g: PSNR %.2f dB, max error %d, %.1f MP/s", blur.name,
+            qPrintable(source.name), radius, reference.psnr, reference.maximumError, throughput);
+        QVERIFY2(reference.psnr >= kMinimumPsnr, "PSNR against the reference is too low.");
+        QVERIFY2(reference.maximumError <= kMaximumError, "Max error against the reference is too high.");
+        if (m_goldenDir.isEmpty() || (variant == 0)) {
+            return;
+        }
+        const QString goldenPath = QDir(m_goldenDir).filePath(source.name
+            + QStringLiteral("-r") + QString::number(radius) + QStringLiteral(".png"));
+        if (m_updateGolden) {
+            // The first real kernel is what we ship, its output is the golden one.
+            if (variant == 1) {
+                QVERIFY(actual.save(goldenPath));
+            }
+            return;
+        }
+        if (!QFileInfo::exists(goldenPath)) {
+            return;
+        }
+        const QImage golden(goldenPath);
+        QVERIFY(!golden.isNull());
+        QCOMPARE(golden.size(), actual.size());
+        const Comparison goldenComparison = compareImages(actual, golden);
+        qInfo("%s %s r=%g: PSNR %.2f dB, max error %d against the golden image", blur.name,
+            qPrintable(source.name), radius, goldenComparison.psnr, goldenComparison.maximumError);
+        QVERIFY2(goldenComparison.psnr >= kMinimumPsnr, "PSNR against the golden image is too low.");
+        QVERIFY2(goldenComparison.maximumError <= kMaximumError, "Max error against the golden image is too high.");
+    }
+
+private:
+    QList<TestImage> m_images = {};
+    QString m_goldenDir = {};
+    bool m_updateGolden = false;
+};
+
+int main(int argc, char *argv[])
+{
+    const QByteArray platform = (qEnvironmentVariableIsSet("QT_QPA_PLATFORM") ?
+        qgetenv("QT_QPA_PLATFORM") : FRAMELESSHELPER_BYTEARRAY_LITERAL("offscreen"));
+    FramelessHelper::Core::initialize();
+    // initialize() forces the xcb plugin on Linux, which needs a display server.
+    qputenv("QT_QPA_PLATFORM", platform);
+    const auto application = std::make_unique<QGuiApplication>(argc, argv);
+    BlurConformance test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_blur.moc"
@@ -0,0 +1,208 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <FramelessHelper/Core/chromepalette.h>
+#include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Core/wallpapersource.h>
+#include <FramelessHelper/Core/private/chromepalette_p.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <FramelessHelper/Core/private/sysapiloader_p.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qbrush.h>
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+#ifdef Q_OS_WINDOWS
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkLibrary, "user32")
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkFunction, "GetSystemMetrics")
+#elif defined(Q_OS_MACOS)
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkLibrary, "libobjc")
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkFunction, "objc_getClass")
+#else
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkLibrary, "libX11")
+FRAMELESSHELPER_STRING_CONSTANT2(BenchmarkFunction, "XInitThreads")
+#endif
+
+// Something which looks like a real wallpaper: smooth gradients plus some hard edges.
+[[nodiscard]] static inline QImage createTestImage(const QSize &size)
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    QLinearGradient gradient(QPointF(0, 0), QPointF(size.width(), size.height()));
+    gradient.setColorAt(0.0, QColor(32, 96, 192));
+    gradient.setColorAt(0.5, QColor(240, 160, 32));
+    gradient.setColorAt(1.0, QColor(16, 128, 64));
+    painter.fillRect(image.rect(), gradient);
+    const int step = qMax(1, (size.width() / 8));
+    for (int x = 0; x < size.width(); x += (step * 2)) {
+        painter.fillRect(QRect(x, 0, step, (size.height() / 2)), QColor(255, 255, 255, 96));
+    }
+    painter.end();
+    return image;
+}
+
+class CoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        m_wallpaper = std::make_unique<ImageWallpaperSource>();
+        m_wallpaper->setImage(createTestImage(QSize(1920, 1080)));
+        MicaMaterial::setWallpaperSource(m_wallpaper.get());
+    }
+
+    void cleanupTestCase()
+    {
+        MicaMaterial::setWallpaperSource(nullptr);
+        m_wallpaper.reset();
+    }
+
+    void blurImage_data()
+    {
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<qreal>("radius");
+        QTest::newRow("256x256, r=16") << QSize(256, 256) << qreal(16);
+        QTest::newRow("256x256, r=128") << QSize(256, 256) << qreal(128);
+        QTest::newRow("960x540, r=128") << QSize(960, 540) << qreal(128);
+        QTest::newRow("1920x1080, r=128") << QSize(1920, 1080) << qreal(128);
+        QTest::newRow("3840x2160, r=128") << QSize(3840, 2160) << qreal(128);
+    }
+
+    void blurImage()
+    {
+#ifdef FRAMELESSHELPER_CORE_NO_PRIVATE
+        QSKIP("The blur is not available without the private Qt headers.");
+#endif
+        QFETCH(const QSize, size);
+        QFETCH(const qreal, radius);
+        const QImage source = createTestImage(size);
+        QImage result = {};
+        QBENCHMARK {
+            result = MicaMaterialPrivate::blurImage(source, radius);
+        }
+        QCOMPARE(result.size(), size);
+    }
+
+    void micaMaterialPaint_data()
+    {
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<qreal>("devicePixelRatio");
+        QTest::newRow("400x300@1x") << QSize(400, 300) << qreal(1);
+        QTest::newRow("800x600@1x") << QSize(800, 600) << qreal(1);
+        QTest::newRow("800x600@2x") << QSize(800, 600) << qreal(2);
+    }
+
+    void micaMaterialPaint()
+    {
+        QFETCH(const QSize, size);
+        QFETCH(const qreal, devicePixelRatio);
+        MicaMaterial material;
+        QImage target(QSizeF(QSizeF(size) * devicePixelRatio).toSize(), QImage::Format_ARGB32_Premultiplied);
+        target.setDevicePixelRatio(devicePixelRatio);
+        const QRect rect = {QPoint(0, 0), size};
+        // The blurred wallpaper is generated asynchronously, we only want to measure the painting itself.
+        QSignalSpy spy(&material, &MicaMaterial::shouldRedraw);
+        {
+            QPainter painter(&target);
+            material.paint(&painter, rect);
+        }
+        std::ignore = spy.wait(10000);
+        QBENCHMARK {
+            QPainter painter(&target);
+            material.paint(&painter, rect);
+        }
+    }
+
+    void chromePaletteRefresh()
+    {
+        static constexpr const int kPaletteCount = 64;
+        std::vector<std::unique_ptr<ChromePalette>> palettes = {};
+        palettes.reserve(kPaletteCount);
+        for (int index = 0; index != kPaletteCount; ++index) {
+            palettes.push_back(std::make_unique<ChromePalette>());
+        }
+        // Each palette only compares the shared snapshot with the one it already has,
+        // so it has to be recalculated every time, otherwise there's nothing to refresh.
+        // This is the whole theme change: one recalculation plus all the palettes following it.
+        QBENCHMARK {
+            ChromePalettePrivate::refreshSystemColors();
+        }
+    }
+
+    void sysApiLoaderGet()
+    {
+        SysApiLoader * const loader = SysApiLoader::instance();
+        if (!loader->isAvailable(kBenchmarkLibrary, kBenchmarkFunction)) {
+            QSKIP("The system library used by this benchmark is not available.");
+        }
+        QFunctionPointer function = nullptr;
+        QBENCHMARK {
+            function = loader->get(kBenchmarkLibrary, kBenchmarkFunction);
+        }
+        QVERIFY(function);
+    }
+
+    void sysApiLoaderCached()
+    {
+        SysApiLoader * const loader = SysApiLoader::instance();
+        if (!loader->isAvailable(kBenchmarkLibrary, kBenchmarkFunction)) {
+            QSKIP("The system library used by this benchmark is not available.");
+        }
+        QFunctionPointer function = nullptr;
+        // This is what API_GET_FUNCTION() expands to.
+        QBENCHMARK {
+            function = SysApiLoader::cached<QFunctionPointer>([]() -> QFunctionPointer {
+                return SysApiLoader::instance()->get(kBenchmarkLibrary, kBenchmarkFunction);
+            });
+        }
+        QVERIFY(function);
+    }
+
+private:
+    std::unique_ptr<ImageWallpaperSource> m_wallpaper = nullptr;
+};
+
+int main(int argc, char *argv[])
+{
+    const QByteArray platform = (qEnvironmentVariableIsSet("QT_QPA_PLATFORM") ?
+        qgetenv("QT_QPA_PLATFORM") : FRAMELESSHELPER_BYTEARRAY_LITERAL("offscreen"));
+    FramelessHelper::Core::initialize();
+    // initialize() forces the xcb plugin on Linux, which needs a display server.
+    qputenv("QT_QPA_PLATFORM", platform);
+    const auto application = std::make_unique<QGuiApplication>(argc, argv);
+    CoreBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_core.moc"
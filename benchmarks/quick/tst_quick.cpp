@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <FramelessHelper/Core/framelesshelper_qt.h>
+#include <FramelessHelper/Quick/framelessquickhelper.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qguiapplication.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qquickitem.h>
+#include <QtTest/qtest.h>
+#include <memory>
+#include <tuple>
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+static constexpr const QSize kWindowSize = {1024, 600};
+static constexpr const int kTitleBarHeight = 32;
+// Somewhere inside the draggable area, not covered by any of the hit test visible children.
+static constexpr const QPoint kProbePoint = {(kWindowSize.width() - 64), (kTitleBarHeight / 2)};
+
+class QuickBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void eventFilter_data()
+    {
+        QTest::addColumn<int>("childCount");
+        QTest::addColumn<int>("eventType");
+        for (auto &&count : {0, 16, 128, 1024}) {
+            const QByteArray suffix = (", " + QByteArray::number(count) + " children");
+            QTest::newRow(QByteArray("move" + suffix).constData()) << count << int(QEvent::MouseMove);
+            QTest::newRow(QByteArray("release" + suffix).constData()) << count << int(QEvent::MouseButtonRelease);
+        }
+    }
+
+    void eventFilter()
+    {
+        QFETCH(const int, childCount);
+        QFETCH(const int, eventType);
+        const auto window = std::make_unique<QQuickWindow>();
+        window->resize(kWindowSize);
+        const auto titleBar = new QQuickItem(window->contentItem());
+        titleBar->setSize(QSizeF(kWindowSize.width(), kTitleBarHeight));
+        FramelessQuickHelper * const helper = FramelessQuickHelper::get(window.get());
+        helper->extendsContentIntoTitleBar();
+        helper->setTitleBarItem(titleBar);
+        // Pack the children into the left part of the title bar, so that the probe point
+        // doesn't hit any of them and every event has to go through all of them.
+        for (int index = 0; index != childCount; ++index) {
+            const auto child = new QQuickItem(titleBar);
+            child->setPosition(QPointF(((index % 100) * 8), (((index / 100) % 4) * 8)));
+            child->setSize(QSizeF(6, 6));
+            helper->setHitTestVisible(child);
+        }
+        window->show();
+        helper->waitForReady();
+        QVERIFY(QTest::qWaitForWindowExposed(window.get()));
+        // Only used on the platforms where we don't need to process native events ourselves.
+        const auto filter = window->findChild<FramelessHelperQt *>();
+        if (!filter) {
+            QSKIP("FramelessHelperQt is not used on this platform.");
+        }
+        const QPoint globalPos = window->mapToGlobal(kProbePoint);
+        const auto type = static_cast<QEvent::Type>(eventType);
+        const Qt::MouseButton button = ((type == QEvent::MouseMove) ? Qt::NoButton : Qt::LeftButton);
+        QBENCHMARK {
+            QMouseEvent event(type, kProbePoint, kProbePoint, globalPos, button, Qt::NoButton, Qt::NoModifier);
+            // Call it directly, we are not interested in the cost of the scene graph's own event handling.
+            std::ignore = static_cast<QObject *>(filter)->eventFilter(window.get(), &event);
+        }
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    const QByteArray platform = (qEnvironmentVariableIsSet("QT_QPA_PLATFORM") ?
+        qgetenv("QT_QPA_PLATFORM") : FRAMELESSHELPER_BYTEARRAY_LITERAL("offscreen"));
+    // The offscreen platform doesn't always come with a usable OpenGL implementation.
+    if (!qEnvironmentVariableIsSet("QT_QUICK_BACKEND")) {
+        qputenv("QT_QUICK_BACKEND", FRAMELESSHELPER_BYTEARRAY_LITERAL("software"));
+    }
+    FramelessHelper::Quick::initialize();
+    // initialize() forces the xcb plugin on Linux, which needs a display server.
+    qputenv("QT_QPA_PLATFORM", platform);
+    const auto application = std::make_unique<QGuiApplication>(argc, argv);
+    QuickBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_quick.moc"
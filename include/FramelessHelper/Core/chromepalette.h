@@ -117,6 +117,7 @@ Q_SIGNALS:
     void closeButtonPressColorChanged();
     void titleBarColorChanged();
     void chromeButtonColorChanged();
+    void paletteChanged();
 
 private:
     QScopedPointer<ChromePalettePrivate> d_ptr;
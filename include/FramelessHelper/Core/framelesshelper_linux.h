@@ -120,6 +120,14 @@ using xcb_button_press_event_t = struct xcb_button_press_event_t
 };
 using xcb_button_release_event_t = xcb_button_press_event_t;
 
+using xcb_rectangle_t = struct xcb_rectangle_t
+{
+    int16_t x;
+    int16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
 using xcb_void_cookie_t = struct xcb_void_cookie_t
 {
     unsigned int sequence;
@@ -219,6 +227,7 @@ using xcb_list_properties_reply_t = struct xcb_list_properties_reply_t
 [[maybe_unused]] inline constexpr const char ATOM_NET_KDE_COMPOSITE_TOGGLING[] = "_NET_KDE_COMPOSITE_TOGGLING";
 [[maybe_unused]] inline constexpr const char ATOM_KDE_NET_WM_BLUR_BEHIND_REGION[] = "_KDE_NET_WM_BLUR_BEHIND_REGION";
 [[maybe_unused]] inline constexpr const char ATOM_GTK_SHOW_WINDOW_MENU[] = "_GTK_SHOW_WINDOW_MENU";
+[[maybe_unused]] inline constexpr const char ATOM_GTK_FRAME_EXTENTS[] = "_GTK_FRAME_EXTENTS";
 [[maybe_unused]] inline constexpr const char ATOM_DEEPIN_NO_TITLEBAR[] = "_DEEPIN_NO_TITLEBAR";
 [[maybe_unused]] inline constexpr const char ATOM_DEEPIN_FORCE_DECORATE[] = "_DEEPIN_FORCE_DECORATE";
 [[maybe_unused]] inline constexpr const char ATOM_NET_WM_DEEPIN_BLUR_REGION_MASK[] = "_NET_WM_DEEPIN_BLUR_REGION_MASK";
@@ -404,6 +413,9 @@ using GValue = struct _GValue;
 using GObject = struct _GObject;
 using GClosure = struct _GClosure;
 using GtkSettings = struct _GtkSettings;
+using GSettings = struct _GSettings;
+using GSettingsSchema = struct _GSettingsSchema;
+using GSettingsSchemaSource = struct _GSettingsSchemaSource;
 
 using GConnectFlags = enum GConnectFlags
 {
@@ -511,6 +523,40 @@ g_clear_object(
     GObject **object_ptr
 );
 
+FRAMELESSHELPER_CORE_API GSettingsSchemaSource *
+g_settings_schema_source_get_default(
+    void
+);
+
+FRAMELESSHELPER_CORE_API GSettingsSchema *
+g_settings_schema_source_lookup(
+    GSettingsSchemaSource *source,
+    const gchar *schema_id,
+    gboolean recursive
+);
+
+FRAMELESSHELPER_CORE_API gboolean
+g_settings_schema_has_key(
+    GSettingsSchema *schema,
+    const gchar *name
+);
+
+FRAMELESSHELPER_CORE_API void
+g_settings_schema_unref(
+    GSettingsSchema *schema
+);
+
+FRAMELESSHELPER_CORE_API GSettings *
+g_settings_new(
+    const gchar *schema_id
+);
+
+FRAMELESSHELPER_CORE_API gchar *
+g_settings_get_string(
+    GSettings *settings,
+    const gchar *key
+);
+
 } // extern "C"
 #endif // FRAMELESSHELPER_HAS_GTK
 
@@ -26,9 +26,14 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 struct SystemParameters;
+class WindowShadowPainter;
 
 class FRAMELESSHELPER_CORE_API FramelessHelperQt : public QObject
 {
@@ -41,6 +46,8 @@ public:
 
     static void addWindow(const SystemParameters *params);
     static void removeWindow(const WId windowId);
+    // Only exists if Option::WindowUseClientSideShadow is set.
+    Q_NODISCARD static WindowShadowPainter *windowShadowPainter(const QWindow *window);
 
 protected:
     Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
@@ -244,6 +244,7 @@ Q_NAMESPACE_EXPORT(FRAMELESSHELPER_CORE_API)
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarHeight = 32;
 [[maybe_unused]] inline constexpr const int kDefaultExtendedTitleBarHeight = 48;
 [[maybe_unused]] inline constexpr const int kDefaultWindowFrameBorderThickness = 1;
+[[maybe_unused]] inline constexpr const int kDefaultWindowCornerRadius = 8;
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarFontPointSize = 11;
 [[maybe_unused]] inline constexpr const int kDefaultTitleBarContentsMargin = 10;
 [[maybe_unused]] inline constexpr const int kMacOSChromeButtonAreaWidth = 60;
@@ -291,7 +292,8 @@ enum class Option : quint8
     ForceNonNativeBackgroundBlur,
     DisableLazyInitializationForMicaMaterial,
     ForceNativeBackgroundBlur,
-    Last = ForceNativeBackgroundBlur
+    WindowUseClientSideShadow,
+    Last = WindowUseClientSideShadow
 };
 Q_ENUM_NS(Option)
 
@@ -449,6 +451,27 @@ enum class WindowCornerStyle : quint8
 };
 Q_ENUM_NS(WindowCornerStyle)
 
+#ifdef Q_OS_LINUX
+enum class X11Atom : quint8
+{
+    NET_SUPPORTED,
+    NET_WM_NAME,
+    NET_WM_MOVERESIZE,
+    NET_SUPPORTING_WM_CHECK,
+    NET_KDE_COMPOSITE_TOGGLING,
+    KDE_NET_WM_BLUR_BEHIND_REGION,
+    GTK_SHOW_WINDOW_MENU,
+    GTK_FRAME_EXTENTS,
+    DEEPIN_NO_TITLEBAR,
+    DEEPIN_FORCE_DECORATE,
+    NET_WM_DEEPIN_BLUR_REGION_MASK,
+    NET_WM_DEEPIN_BLUR_REGION_ROUNDED,
+    UTF8_STRING,
+    Last = UTF8_STRING
+};
+Q_ENUM_NS(X11Atom)
+#endif // Q_OS_LINUX
+
 struct VersionInfo
 {
     int version = 0;
@@ -476,6 +499,47 @@ struct Dpi
     }
 };
 
+struct LatencyHistogram
+{
+    // Bucket N counts the samples shorter than 10^N microseconds,
+    // the last bucket counts everything that's even slower.
+    static constexpr const int BucketCount = 7;
+
+    quint64 count = 0;
+    quint64 totalNsecs = 0;
+    quint64 maxNsecs = 0;
+    quint64 buckets[BucketCount] = {};
+};
+
+struct RuntimeStatistics
+{
+    quint64 wallpaperRebuildsRequested = 0;
+    quint64 wallpaperRebuildsCoalesced = 0;
+    quint64 wallpaperRebuildsCompleted = 0;
+    quint64 wallpaperRebuildsCancelled = 0;
+    LatencyHistogram blurDuration = {};
+    quint64 micaPaints = 0;
+    quint64 micaPixelsBlitted = 0;
+    quint64 micaBrushRegenerations = 0;
+    LatencyHistogram hitTests = {};
+    quint64 themeQueries = 0;
+    quint64 cursorUpdates = 0;
+    quint64 qtWindows = 0;
+    quint64 win32Windows = 0;
+};
+
+struct CacheMemoryUsage
+{
+    quint64 wallpapers = 0;
+    quint64 materialBrushes = 0;
+    quint64 iconFont = 0;
+    quint64 glyphs = 0;
+    quint64 images = 0;
+    quint64 shadows = 0;
+    quint64 total = 0;
+    quint64 budget = 0; // Zero means unlimited.
+};
+
 } // namespace Global
 
 namespace FramelessHelper::Core
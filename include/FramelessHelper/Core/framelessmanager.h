@@ -49,6 +49,12 @@ public:
     Q_NODISCARD QString wallpaper() const;
     Q_NODISCARD Global::WallpaperAspectStyle wallpaperAspectStyle() const;
 
+    // A snapshot of the internal counters, statisticsUpdated() is emitted
+    // periodically while anything is connected to it.
+    Q_NODISCARD Global::RuntimeStatistics statistics() const;
+    // How much memory the image caches are holding, see FramelessConfig::setCacheMemoryBudget().
+    Q_NODISCARD Global::CacheMemoryUsage cacheMemoryUsage() const;
+
 public Q_SLOTS:
     void addWindow(const SystemParameters *params);
     void removeWindow(const WId windowId);
@@ -57,6 +63,11 @@ public Q_SLOTS:
 Q_SIGNALS:
     void systemThemeChanged();
     void wallpaperChanged();
+    void statisticsUpdated();
+
+protected:
+    void connectNotify(const QMetaMethod &signal) override;
+    void disconnectNotify(const QMetaMethod &signal) override;
 
 private:
     explicit FramelessManager(QObject *parent = nullptr);
@@ -29,6 +29,7 @@
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 class MicaMaterialPrivate;
+class WallpaperSource;
 
 class FRAMELESSHELPER_CORE_API MicaMaterial : public QObject
 {
@@ -61,6 +62,10 @@ public:
     Q_NODISCARD bool isFallbackEnabled() const;
     void setFallbackEnabled(const bool value);
 
+    // Shared by all MicaMaterial instances. Passing nullptr restores the system wallpaper.
+    Q_NODISCARD static WallpaperSource *wallpaperSource();
+    static void setWallpaperSource(WallpaperSource *source);
+
 public Q_SLOTS:
     void paint(QPainter *painter, const QRect &rect, const bool active = true);
 
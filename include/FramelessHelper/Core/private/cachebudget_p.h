@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <functional>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Keeps track of how much memory our image caches are holding, and asks them
+// to shrink once the total goes over the budget set through FramelessConfig.
+class FRAMELESSHELPER_CORE_API CacheBudget : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(CacheBudget)
+
+public:
+    enum class Cache : quint8
+    {
+        Wallpapers,
+        MaterialBrushes,
+        IconFont,
+        Glyphs,
+        Images,
+        Shadows,
+        Last = Shadows
+    };
+    Q_ENUM(Cache)
+
+    // Asked to free the given amount of bytes, it's always called from the main thread.
+    // The caches report their new usage themselves, once they have actually shrunk.
+    using Trimmer = std::function<void(const qint64 bytes)>;
+
+    Q_NODISCARD static CacheBudget *instance();
+
+    Q_NODISCARD qint64 budget() const;
+    void setBudget(const qint64 bytes);
+
+    // Both are thread safe.
+    void setUsage(const Cache cache, const qint64 bytes);
+    void addUsage(const Cache cache, const qint64 delta);
+
+    Q_NODISCARD qint64 usage(const Cache cache) const;
+    Q_NODISCARD qint64 totalUsage() const;
+    // How many bytes can still be allocated without going over the budget.
+    Q_NODISCARD qint64 available() const;
+    Q_NODISCARD Global::CacheMemoryUsage snapshot() const;
+
+    void setTrimmer(const Cache cache, const Trimmer &trimmer);
+
+public Q_SLOTS:
+    void enforce();
+
+private:
+    explicit CacheBudget(QObject *parent = nullptr);
+    ~CacheBudget() override;
+
+    void scheduleEnforce();
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -26,6 +26,7 @@
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
 #include <optional>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -38,28 +39,40 @@ class FRAMELESSHELPER_CORE_API ChromePalettePrivate : public QObject
     Q_DISABLE_COPY_MOVE(ChromePalettePrivate)
 
 public:
+    // System-defined colors, shared by all the palettes using the same system theme.
+    struct Colors
+    {
+        QColor titleBarActiveBackgroundColor = {};
+        QColor titleBarInactiveBackgroundColor = {};
+        QColor titleBarActiveForegroundColor = {};
+        QColor titleBarInactiveForegroundColor = {};
+        QColor chromeButtonNormalColor = {};
+        QColor chromeButtonHoverColor = {};
+        QColor chromeButtonPressColor = {};
+        QColor closeButtonNormalColor = {};
+        QColor closeButtonHoverColor = {};
+        QColor closeButtonPressColor = {};
+    };
+    using ColorsPtr = std::shared_ptr<const Colors>;
+
     explicit ChromePalettePrivate(ChromePalette *q);
     ~ChromePalettePrivate() override;
 
     Q_NODISCARD static ChromePalettePrivate *get(ChromePalette *q);
     Q_NODISCARD static const ChromePalettePrivate *get(const ChromePalette *q);
 
+    Q_NODISCARD static ColorsPtr systemColors();
+    // Calculates the system colors again and refreshes all the palettes, just like
+    // a system theme change does.
+    static void refreshSystemColors();
+
 public Q_SLOTS:
     void refresh();
 
 private:
     ChromePalette *q_ptr = nullptr;
     // System-defined ones:
-    QColor titleBarActiveBackgroundColor_sys = {};
-    QColor titleBarInactiveBackgroundColor_sys = {};
-    QColor titleBarActiveForegroundColor_sys = {};
-    QColor titleBarInactiveForegroundColor_sys = {};
-    QColor chromeButtonNormalColor_sys = {};
-    QColor chromeButtonHoverColor_sys = {};
-    QColor chromeButtonPressColor_sys = {};
-    QColor closeButtonNormalColor_sys = {};
-    QColor closeButtonHoverColor_sys = {};
-    QColor closeButtonPressColor_sys = {};
+    ColorsPtr sys = nullptr;
     // User-defined ones:
     std::optional<QColor> titleBarActiveBackgroundColor = std::nullopt;
     std::optional<QColor> titleBarInactiveBackgroundColor = std::nullopt;
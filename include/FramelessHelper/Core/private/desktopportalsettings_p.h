@@ -0,0 +1,84 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtGui/qcolor.h>
+#include <memory>
+#include <optional>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class DesktopPortalSettingsListener;
+
+class FRAMELESSHELPER_CORE_API DesktopPortalSettings : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(DesktopPortalSettings)
+
+public:
+    enum class ColorScheme : quint8
+    {
+        NoPreference = 0,
+        PreferDark = 1,
+        PreferLight = 2
+    };
+    Q_ENUM(ColorScheme)
+
+    // An empty connection name means the session bus, others are expected to be
+    // registered through QDBusConnection::connectToBus() (mainly for testing).
+    explicit DesktopPortalSettings(const QString &connectionName = {}, QObject *parent = nullptr);
+    ~DesktopPortalSettings() override;
+
+    Q_NODISCARD static DesktopPortalSettings *instance();
+
+    // The portal is queried asynchronously. Until it answers the callers are expected to
+    // assume the default appearance, and only fall back to the GTK settings when it turns
+    // out that isAvailable() is false after initialized() has been emitted.
+    Q_NODISCARD bool isInitialized() const;
+    Q_NODISCARD bool isAvailable() const;
+    Q_NODISCARD std::optional<ColorScheme> colorScheme() const;
+    Q_NODISCARD std::optional<QColor> accentColor() const;
+
+    void handleSettingChanged(const QString &nameSpace, const QString &key, const QVariant &value);
+
+Q_SIGNALS:
+    void initialized();
+    void colorSchemeChanged();
+    void accentColorChanged();
+
+private:
+    void initialize();
+
+private:
+    QString m_connectionName = {};
+    bool m_initialized = false;
+    bool m_available = false;
+    std::optional<ColorScheme> m_colorScheme = std::nullopt;
+    std::optional<QColor> m_accentColor = std::nullopt;
+    std::unique_ptr<DesktopPortalSettingsListener> m_listener = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,94 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qfilesystemwatcher.h>
+#include <QtCore/qdatetime.h>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class FRAMELESSHELPER_CORE_API DesktopWallpaperWatcher : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(DesktopWallpaperWatcher)
+
+public:
+    enum class Desktop : quint8
+    {
+        Unknown,
+        GNOME,
+        KDE,
+        XFCE
+    };
+    Q_ENUM(Desktop)
+
+    explicit DesktopWallpaperWatcher(QObject *parent = nullptr);
+    ~DesktopWallpaperWatcher() override;
+
+    Q_NODISCARD static DesktopWallpaperWatcher *instance();
+
+    Q_NODISCARD Desktop desktop() const;
+    Q_NODISCARD QString wallpaper() const;
+    Q_NODISCARD Global::WallpaperAspectStyle aspectStyle() const;
+
+Q_SIGNALS:
+    void wallpaperChanged();
+
+private Q_SLOTS:
+    void refresh();
+
+private:
+    void initialize();
+    void updateWatchedPaths();
+    void scheduleContentHash();
+    void handleContentHash(const QString &filePath, const QByteArray &hash);
+
+private:
+    mutable QMutex m_mutex;
+    Desktop m_desktop = Desktop::Unknown;
+    QString m_wallpaper = {};
+    Global::WallpaperAspectStyle m_aspectStyle = Global::WallpaperAspectStyle::Fill;
+    QByteArray m_contentHash = {};
+    qint64 m_imageSize = -1;
+    QDateTime m_imageLastModified = {};
+    bool m_imageFileChanged = false;
+    std::unique_ptr<QThread> m_hashThread = nullptr;
+    bool m_hashRunning = false;
+    bool m_hashPending = false;
+    QStringList m_configFiles = {};
+    // Children, so that they follow moveToThread().
+    QFileSystemWatcher m_watcher{this};
+    QTimer m_refreshTimer{this};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -41,6 +41,10 @@ public:
     void set(const Global::Option option, const bool on = true);
     Q_NODISCARD bool isSet(const Global::Option option) const;
 
+    // The maximum amount of memory (in bytes) the image caches may hold, zero means unlimited.
+    Q_NODISCARD qint64 cacheMemoryBudget() const;
+    void setCacheMemoryBudget(const qint64 bytes);
+
     static void setLoadFromEnvironmentVariablesDisabled(const bool on = true);
     static void setLoadFromConfigurationFileDisabled(const bool on = true);
 
@@ -100,6 +100,10 @@ using FramelessParamsConst = const SystemParameters *;
 using FramelessParamsRef = SystemParameters &;
 using FramelessParamsConstRef = const SystemParameters &;
 
+// Set by WindowShadowPainter on the window it draws the shadow for (in device independent
+// pixels), the hit tests read it back through Utils::windowShadowMargins().
+[[maybe_unused]] inline constexpr const char kWindowShadowMarginsProperty[] = "__FRAMELESSHELPER_WINDOW_SHADOW_MARGINS__";
+
 FRAMELESSHELPER_CORE_API void registerInitializeHook(const InitializeHookCallback &cb);
 FRAMELESSHELPER_CORE_API void registerUninitializeHook(const UninitializeHookCallback &cb);
 
@@ -28,6 +28,11 @@
 #include <QtCore/qtimer.h>
 #include <optional>
 
+QT_BEGIN_NAMESPACE
+class QFont;
+class QPixmap;
+QT_END_NAMESPACE
+
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
 struct SystemParameters;
@@ -48,6 +53,8 @@ public:
 
     static void initializeIconFont();
     Q_NODISCARD static QFont getIconFont();
+    Q_NODISCARD static QPixmap getGlyphPixmap(const QString &glyph, const QColor &color,
+                                              const int pointSize, const qreal devicePixelRatio);
 
     Q_NODISCARD Global::SystemTheme systemTheme() const;
     Q_NODISCARD QColor systemAccentColor() const;
@@ -59,8 +66,10 @@ public:
 
     Q_INVOKABLE void notifySystemThemeHasChangedOrNot();
     Q_INVOKABLE void notifyWallpaperHasChangedOrNot();
+    Q_INVOKABLE void updateStatisticsTimer();
 
     Q_NODISCARD static bool usePureQtImplementation();
+    static void ensureWallpaperWatcher();
 
     void setOverrideTheme(const Global::SystemTheme theme);
     Q_NODISCARD bool isThemeOverrided() const;
@@ -68,7 +77,7 @@ public:
 private:
     void initialize();
     void doNotifySystemThemeHasChangedOrNot();
-    void doNotifyWallpaperHasChangedOrNot();
+    void doNotifyWallpaperHasChangedOrNot(const bool force = false);
 
 private:
     FramelessManager *q_ptr = nullptr;
@@ -82,6 +91,7 @@ private:
     Global::WallpaperAspectStyle m_wallpaperAspectStyle = Global::WallpaperAspectStyle::Fill;
     QTimer m_themeTimer{};
     QTimer m_wallpaperTimer{};
+    QTimer m_statisticsTimer{};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
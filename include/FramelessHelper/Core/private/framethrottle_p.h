@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qtimer.h>
+#include <functional>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Folds bursts of requests (interactive resizing sends far more resize events than the
+// screen can show) into at most one call of the callback per frame of the window's screen.
+// The first request within a frame is honored, the ones arriving meanwhile are dropped.
+class FRAMELESSHELPER_CORE_API FrameThrottle : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FrameThrottle)
+
+public:
+    using Callback = std::function<void()>;
+
+    explicit FrameThrottle(QWindow *window, const Callback &callback, QObject *parent = nullptr);
+    ~FrameThrottle() override;
+
+    Q_NODISCARD static int frameInterval(const QWindow *window);
+
+public Q_SLOTS:
+    void schedule();
+    void cancel();
+
+private:
+    QPointer<QWindow> m_window = nullptr;
+    Callback m_callback = nullptr;
+    QTimer m_timer;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
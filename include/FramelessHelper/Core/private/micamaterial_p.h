@@ -25,7 +25,15 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qpointer.h>
 #include <QtGui/qbrush.h>
+#include <QtGui/qpixmap.h>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QScreen;
+class QWindow;
+QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -37,6 +45,16 @@ struct Transform
     qreal Vertical = 0;
 };
 
+struct BlurredWallpaper
+{
+    QSize monitorSize = {};
+    QSize size = {};
+    Transform transform = {};
+    QPixmap pixmap = {};
+    quint64 generation = 0;
+    int reduction = 1; // Built at 1/reduction of the full resolution to stay within the cache budget.
+};
+
 class FRAMELESSHELPER_CORE_API MicaMaterialPrivate : public QObject
 {
     Q_OBJECT
@@ -44,6 +62,29 @@ class FRAMELESSHELPER_CORE_API MicaMaterialPrivate : public QObject
     Q_DECLARE_PUBLIC(MicaMaterial)
 
 public:
+    struct MaterialBrushKey
+    {
+        Global::SystemTheme theme = Global::SystemTheme::Unknown;
+        QRgb tintColor = 0;
+        qreal tintOpacity = 0.0;
+        qreal noiseOpacity = 0.0;
+        qreal devicePixelRatio = 1.0;
+
+        Q_NODISCARD friend bool operator==(const MaterialBrushKey &lhs, const MaterialBrushKey &rhs) noexcept
+        {
+            return ((lhs.theme == rhs.theme) && (lhs.tintColor == rhs.tintColor)
+                && qFuzzyCompare(lhs.tintOpacity, rhs.tintOpacity)
+                && qFuzzyCompare(lhs.noiseOpacity, rhs.noiseOpacity)
+                && qFuzzyCompare(lhs.devicePixelRatio, rhs.devicePixelRatio));
+        }
+
+        Q_NODISCARD friend bool operator!=(const MaterialBrushKey &lhs, const MaterialBrushKey &rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+    using BrushPtr = std::shared_ptr<const QBrush>;
+
     explicit MicaMaterialPrivate(MicaMaterial *q);
     ~MicaMaterialPrivate() override;
 
@@ -51,23 +92,36 @@ public:
     Q_NODISCARD static const MicaMaterialPrivate *get(const MicaMaterial *q);
 
     Q_NODISCARD static QColor systemFallbackColor();
+    // The same blur the wallpaper goes through, also used by the benchmarks.
+    Q_NODISCARD static QImage blurImage(const QImage &image, const qreal radius);
+
+    Q_NODISCARD BrushPtr materialBrush(const qreal devicePixelRatio);
 
-    Q_NODISCARD static QSize monitorSize();
-    Q_NODISCARD static QSize wallpaperSize();
+    void setWindow(QWindow *value);
+    Q_NODISCARD bool isSuspended() const;
 
-    Q_NODISCARD QPoint mapToWallpaper(const QPoint &pos) const;
-    Q_NODISCARD QSize mapToWallpaper(const QSize &size) const;
-    Q_NODISCARD QRect mapToWallpaper(const QRect &rect) const;
+    Q_NODISCARD static QScreen *screenForRect(const QRect &rect);
+    Q_NODISCARD static QSize monitorSize(const QScreen *screen);
+    Q_NODISCARD static QSize wallpaperSize(const QSize &monitorSize);
+
+    Q_NODISCARD static QPoint mapToWallpaper(const QPoint &pos, const BlurredWallpaper &wallpaper);
+    Q_NODISCARD static QSize mapToWallpaper(const QSize &size, const BlurredWallpaper &wallpaper);
+    Q_NODISCARD static QRect mapToWallpaper(const QRect &rect, const BlurredWallpaper &wallpaper);
 
 public Q_SLOTS:
     void maybeGenerateBlurredWallpaper(const bool force = false);
+    void prepareBlurredWallpaper(const QScreen *screen);
     void updateMaterialBrush();
     void paint(QPainter *painter, const QRect &rect, const bool active = true);
     void forceRebuildWallpaper();
+    void requestRedraw();
+    void updateSuspended();
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
 
 private:
     void initialize();
-    void prepareGraphicsResources();
 
 private:
     MicaMaterial *q_ptr = nullptr;
@@ -76,9 +130,13 @@ private:
     QColor fallbackColor = {};
     qreal noiseOpacity = 0.0;
     bool fallbackEnabled = true;
-    QBrush micaBrush = {};
+    BrushPtr micaBrush = nullptr;
+    MaterialBrushKey micaBrushKey = {};
     bool initialized = false;
-    Transform transform = {};
+    QPointer<QWindow> window = nullptr;
+    QMetaObject::Connection windowVisibilityChangeConnection = {};
+    bool suspended = false;
+    bool redrawPending = false;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qelapsedtimer.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Every thread writes to its own set of counters without any locking,
+// they are only summed up when somebody asks for a snapshot.
+class FRAMELESSHELPER_CORE_API StatisticsRecorder
+{
+    Q_DISABLE_COPY_MOVE(StatisticsRecorder)
+
+public:
+    enum class Counter : quint8
+    {
+        WallpaperRebuildRequested,
+        WallpaperRebuildCoalesced,
+        WallpaperRebuildCompleted,
+        WallpaperRebuildCancelled,
+        MicaPaint,
+        MicaPixelBlitted,
+        MicaBrushRegeneration,
+        ThemeQuery,
+        CursorUpdate,
+        QtWindow,
+        Win32Window,
+        Last = Win32Window
+    };
+
+    enum class Histogram : quint8
+    {
+        BlurDuration,
+        HitTest,
+        Last = HitTest
+    };
+
+    // The window counters are gauges, pass a negative delta when a window goes away.
+    static void add(const Counter counter, const qint64 delta = 1);
+    static void record(const Histogram histogram, const qint64 nsecs);
+    Q_NODISCARD static Global::RuntimeStatistics snapshot();
+
+private:
+    StatisticsRecorder() = delete;
+    ~StatisticsRecorder() = delete;
+};
+
+class [[nodiscard]] StatisticsTimer
+{
+    Q_DISABLE_COPY_MOVE(StatisticsTimer)
+
+public:
+    explicit StatisticsTimer(const StatisticsRecorder::Histogram histogram) noexcept : m_histogram(histogram)
+    {
+        m_timer.start();
+    }
+
+    ~StatisticsTimer()
+    {
+        StatisticsRecorder::record(m_histogram, m_timer.nsecsElapsed());
+    }
+
+private:
+    StatisticsRecorder::Histogram m_histogram = StatisticsRecorder::Histogram::BlurDuration;
+    QElapsedTimer m_timer{};
+};
+
+FRAMELESSHELPER_END_NAMESPACE
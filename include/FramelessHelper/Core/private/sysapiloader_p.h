@@ -25,6 +25,10 @@
 #pragma once
 
 #include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstringlist.h>
+#include <atomic>
+#include <utility>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -34,6 +38,8 @@ class FRAMELESSHELPER_CORE_API SysApiLoader : public QObject
     Q_DISABLE_COPY_MOVE(SysApiLoader)
 
 public:
+    using PreloadManifest = QList<std::pair<QString, QStringList>>;
+
     Q_NODISCARD static SysApiLoader *instance();
 
     Q_NODISCARD static QString platformSharedLibrarySuffixName();
@@ -47,12 +53,46 @@ public:
 
     Q_NODISCARD QFunctionPointer get(const QString &library, const QString &function);
 
+    static void preload(const PreloadManifest &manifest);
+    static void waitForPreload();
+
     template<typename T>
     Q_NODISCARD T get(const QString &library, const QString &function)
     {
         return reinterpret_cast<T>(get(library, function));
     }
 
+    // The resolver is expected to be a unique lambda for each call site, so that every
+    // (library, function) pair gets its own static slot and we only have to go through
+    // the string based lookup once, instead of building the key again on every call.
+    template<typename T, typename Resolver>
+    Q_NODISCARD static T cached(const Resolver &resolver)
+    {
+        static std::atomic<QFunctionPointer> symbol = nullptr;
+        QFunctionPointer result = symbol.load(std::memory_order_acquire);
+        if (!result) {
+            result = resolver();
+            if (result) {
+                symbol.store(result, std::memory_order_release);
+            }
+        }
+        return reinterpret_cast<T>(result);
+    }
+
+    template<typename Resolver>
+    Q_NODISCARD static bool cachedAvailable(const Resolver &resolver)
+    {
+        static std::atomic_bool available = false;
+        if (available.load(std::memory_order_acquire)) {
+            return true;
+        }
+        const bool result = resolver();
+        if (result) {
+            available.store(true, std::memory_order_release);
+        }
+        return result;
+    }
+
 private:
     explicit SysApiLoader(QObject *parent = nullptr);
     ~SysApiLoader() override;
@@ -61,16 +101,23 @@ private:
 FRAMELESSHELPER_END_NAMESPACE
 
 #define API_AVAILABLE(lib, func) \
-  (FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->isAvailable(k##lib, k##func))
+  (FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::cachedAvailable([]() -> bool { \
+     return FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->isAvailable(k##lib, k##func); \
+   }))
+
+#define API_GET_FUNCTION(lib, type, name) \
+  (FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::cached<type>([]() -> QFunctionPointer { \
+     return FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get(k##lib, k##name); \
+   }))
 
 #define API_CALL_FUNCTION(lib, func, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<decltype(&func)>(k##lib, k##func))(__VA_ARGS__))
+  ((API_GET_FUNCTION(lib, decltype(&func), func))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION2(lib, func, type, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<type>(k##lib, k##func))(__VA_ARGS__))
+  ((API_GET_FUNCTION(lib, type, func))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION3(lib, func, name, ...) \
-  ((FRAMELESSHELPER_PREPEND_NAMESPACE(SysApiLoader)::instance()->get<decltype(&func)>(k##lib, k##name))(__VA_ARGS__))
+  ((API_GET_FUNCTION(lib, decltype(&func), name))(__VA_ARGS__))
 
 #define API_CALL_FUNCTION4(lib, func, ...) API_CALL_FUNCTION3(lib, _##func, func, __VA_ARGS__)
 
@@ -90,4 +137,5 @@ FRAMELESSHELPER_END_NAMESPACE
 #  define API_XLIB_AVAILABLE(func) API_AVAILABLE(libX11, func)
 #  define API_XCB_AVAILABLE(func) API_AVAILABLE(libxcb, func)
 #  define API_GTK_AVAILABLE(func) API_AVAILABLE(libgtk, func)
+#  define API_GIO_AVAILABLE(func) API_AVAILABLE(libgio, func)
 #endif // Q_OS_LINUX
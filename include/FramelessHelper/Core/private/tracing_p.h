@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// Records Chrome trace event format (JSON array) spans, which can be loaded by
+// chrome://tracing or https://ui.perfetto.dev directly. Only built into the call
+// sites if FRAMELESSHELPER_ENABLE_TRACING is defined, and only active at runtime
+// if the FRAMELESSHELPER_TRACE_FILE environment variable points to a file.
+class FRAMELESSHELPER_CORE_API Tracer
+{
+    Q_DISABLE_COPY_MOVE(Tracer)
+
+public:
+    // Both the name and the category must be string literals, they are not copied.
+    Q_NODISCARD static bool isEnabled();
+    Q_NODISCARD static qint64 timestamp();
+    static void addCompleteEvent(const char *category, const char *name, const qint64 start, const qint64 end);
+    static void addInstantEvent(const char *category, const char *name);
+    static void flush();
+
+private:
+    Tracer() = delete;
+    ~Tracer() = delete;
+};
+
+class [[nodiscard]] TraceScope
+{
+    Q_DISABLE_COPY_MOVE(TraceScope)
+
+public:
+    explicit TraceScope(const char *category, const char *name) noexcept
+    {
+        if (!Tracer::isEnabled()) {
+            return;
+        }
+        m_category = category;
+        m_name = name;
+        m_start = Tracer::timestamp();
+    }
+
+    ~TraceScope()
+    {
+        if (m_start < 0) {
+            return;
+        }
+        Tracer::addCompleteEvent(m_category, m_name, m_start, Tracer::timestamp());
+    }
+
+private:
+    const char *m_category = nullptr;
+    const char *m_name = nullptr;
+    qint64 m_start = -1;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#define FRAMELESSHELPER_TRACE_CONCAT_IMPL(a, b) a##b
+#define FRAMELESSHELPER_TRACE_CONCAT(a, b) FRAMELESSHELPER_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef FRAMELESSHELPER_ENABLE_TRACING
+#  define FRAMELESSHELPER_TRACE_SCOPE(category, name) \
+     const FRAMELESSHELPER_PREPEND_NAMESPACE(TraceScope) FRAMELESSHELPER_TRACE_CONCAT(__framelesshelper_trace_scope_, __LINE__)(category, name)
+#  define FRAMELESSHELPER_TRACE_INSTANT(category, name) \
+     do { \
+       if (FRAMELESSHELPER_PREPEND_NAMESPACE(Tracer)::isEnabled()) { \
+         FRAMELESSHELPER_PREPEND_NAMESPACE(Tracer)::addInstantEvent(category, name); \
+       } \
+     } while (false)
+#else // !FRAMELESSHELPER_ENABLE_TRACING
+#  define FRAMELESSHELPER_TRACE_SCOPE(category, name)
+#  define FRAMELESSHELPER_TRACE_INSTANT(category, name) do {} while (false)
+#endif // FRAMELESSHELPER_ENABLE_TRACING
@@ -0,0 +1,55 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+class QRegion;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+// The rounded corners used by Option::WindowUseRoundCorners. The antialiased corner
+// masks and the window shape derived from them are only generated once per radius
+// and device pixel ratio, resizing a window just puts the cached pieces together again.
+class FRAMELESSHELPER_CORE_API WindowCornerMask
+{
+    Q_DISABLE_COPY_MOVE(WindowCornerMask)
+
+public:
+    // In device independent pixels, suitable for QWindow::setMask().
+    Q_NODISCARD static QRegion windowRegion(const QSize &size, const int radius, const qreal devicePixelRatio);
+    // Clears the four corners with antialiasing, only useful for translucent surfaces.
+    static void eraseCorners(QPainter *painter, const QSize &size, const int radius);
+
+private:
+    WindowCornerMask() = delete;
+    ~WindowCornerMask() = delete;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
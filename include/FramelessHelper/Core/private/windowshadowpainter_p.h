@@ -0,0 +1,100 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtGui/qimage.h>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class WindowShadowPainter;
+class FrameThrottle;
+
+class FRAMELESSHELPER_CORE_API WindowShadowPainterPrivate : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PUBLIC(WindowShadowPainter)
+    Q_DISABLE_COPY_MOVE(WindowShadowPainterPrivate)
+
+public:
+    struct AtlasKey
+    {
+        int radius = 0;
+        int cornerRadius = 0;
+        QRgb color = 0;
+        qreal devicePixelRatio = 1.0;
+
+        Q_NODISCARD friend bool operator==(const AtlasKey &lhs, const AtlasKey &rhs) noexcept
+        {
+            return ((lhs.radius == rhs.radius) && (lhs.cornerRadius == rhs.cornerRadius)
+                && (lhs.color == rhs.color) && qFuzzyCompare(lhs.devicePixelRatio, rhs.devicePixelRatio));
+        }
+
+        Q_NODISCARD friend bool operator!=(const AtlasKey &lhs, const AtlasKey &rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    explicit WindowShadowPainterPrivate(WindowShadowPainter *q);
+    ~WindowShadowPainterPrivate() override;
+
+    Q_NODISCARD static WindowShadowPainterPrivate *get(WindowShadowPainter *q);
+    Q_NODISCARD static const WindowShadowPainterPrivate *get(const WindowShadowPainter *q);
+
+    // The nine-slice source of the shadow. It's blurred only once and then shared
+    // by all the painters which ask for the same shadow, whatever their size is.
+    Q_NODISCARD static QImage shadowAtlas(const AtlasKey &key);
+
+    // Maximized, minimized and full screen windows don't have any shadow.
+    Q_NODISCARD bool isShadowVisible() const;
+
+public Q_SLOTS:
+    void paint(QPainter *painter, const QSize &size, const bool active) const;
+    void scheduleWindowMarginsUpdate();
+    void updateWindowMargins();
+
+protected:
+    Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
+
+private:
+    void initialize();
+
+private:
+    WindowShadowPainter *q_ptr = nullptr;
+    int m_radius = 0;
+    int m_cornerRadius = 0;
+    QColor m_activeColor = {};
+    QColor m_inactiveColor = {};
+    QPointer<QWindow> m_window = nullptr;
+    FrameThrottle *m_windowMarginsThrottle = nullptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -46,6 +46,8 @@ namespace Utils
     Qt::CursorShape calculateCursorShape(const QWindow *window, const QPoint &pos);
 [[nodiscard]] FRAMELESSHELPER_CORE_API
     Qt::Edges calculateWindowEdges(const QWindow *window, const QPoint &pos);
+[[nodiscard]] FRAMELESSHELPER_CORE_API
+    QMargins windowShadowMargins(const QWindow *window);
 FRAMELESSHELPER_CORE_API void startSystemMove(QWindow *window, const QPoint &globalPos);
 FRAMELESSHELPER_CORE_API void startSystemResize(QWindow *window, const Qt::Edges edges, const QPoint &globalPos);
 [[nodiscard]] FRAMELESSHELPER_CORE_API QString getSystemButtonGlyph(const Global::SystemButtonType button);
@@ -175,6 +177,7 @@ FRAMELESSHELPER_CORE_API void setWindowProperty
      const void *data, const quint32 data_len, const uint8_t format);
 FRAMELESSHELPER_CORE_API void clearWindowProperty(const WId windowId, const xcb_atom_t prop);
 [[nodiscard]] FRAMELESSHELPER_CORE_API xcb_atom_t internAtom(const char *name);
+[[nodiscard]] FRAMELESSHELPER_CORE_API xcb_atom_t x11_atom(const Global::X11Atom atom);
 [[nodiscard]] FRAMELESSHELPER_CORE_API QString getWindowManagerName();
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isSupportedByWindowManager(const xcb_atom_t atom);
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isSupportedByRootWindow(const xcb_atom_t atom);
@@ -187,6 +190,8 @@ FRAMELESSHELPER_CORE_API void sendMoveResizeMessage
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool isCustomDecorationSupported();
 [[nodiscard]] FRAMELESSHELPER_CORE_API bool
     setPlatformPropertiesForWindow(QWindow *window, const QVariantHash &props);
+FRAMELESSHELPER_CORE_API void setWindowShadowMargins
+    (const WId windowId, const QSize &size, const QMargins &margins, const int resizeBorderThickness);
 #endif // Q_OS_LINUX
 
 #ifdef Q_OS_MACOS
@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+#include <QtGui/qimage.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class ImageWallpaperSourcePrivate;
+
+// Supplies the picture MicaMaterial blurs, instead of the system wallpaper file.
+// image() is called from the wallpaper thread, so it may block but must be thread-safe,
+// and the image it returns must own its pixels, it's still used after image() returned.
+// Emit changed() to trigger a rebuild. Subclasses must unregister the source at the
+// start of their destructor (which waits for an image() call that is still running).
+class FRAMELESSHELPER_CORE_API WallpaperSource : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(WallpaperSource)
+
+public:
+    explicit WallpaperSource(QObject *parent = nullptr);
+    ~WallpaperSource() override;
+
+    // The returned image will be shrinked if it's larger than the given size.
+    Q_NODISCARD virtual QImage image(const QSize &maximumSize) = 0;
+    Q_NODISCARD virtual Global::WallpaperAspectStyle aspectStyle() const;
+
+Q_SIGNALS:
+    void changed();
+};
+
+class FRAMELESSHELPER_CORE_API ImageWallpaperSource : public WallpaperSource
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ImageWallpaperSource)
+    Q_DECLARE_PRIVATE(ImageWallpaperSource)
+
+public:
+    explicit ImageWallpaperSource(QObject *parent = nullptr);
+    ~ImageWallpaperSource() override;
+
+    Q_NODISCARD QImage image(const QSize &maximumSize) override;
+    Q_NODISCARD Global::WallpaperAspectStyle aspectStyle() const override;
+
+    void setImage(const QImage &value);
+    // Uses the given pixels without keeping a copy of them (e.g. a memory mapped file),
+    // the buffer must stay valid until another image is set or the source is destroyed.
+    // Each rebuild copies (and shrinks) the pixels it needs while holding the buffer.
+    void setImageData(const uchar *data, const QSize &size, const qsizetype bytesPerLine, const QImage::Format format);
+    void setAspectStyle(const Global::WallpaperAspectStyle value);
+
+private:
+    QScopedPointer<ImageWallpaperSourcePrivate> d_ptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
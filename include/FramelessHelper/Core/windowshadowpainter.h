@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <FramelessHelper/Core/framelesshelpercore_global.h>
+
+QT_BEGIN_NAMESPACE
+class QWindow;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class WindowShadowPainterPrivate;
+
+class FRAMELESSHELPER_CORE_API WindowShadowPainter : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(WindowShadowPainter)
+    Q_DECLARE_PRIVATE(WindowShadowPainter)
+
+    Q_PROPERTY(int radius READ radius WRITE setRadius NOTIFY radiusChanged FINAL)
+    Q_PROPERTY(int cornerRadius READ cornerRadius WRITE setCornerRadius NOTIFY cornerRadiusChanged FINAL)
+    Q_PROPERTY(QColor activeColor READ activeColor WRITE setActiveColor NOTIFY activeColorChanged FINAL)
+    Q_PROPERTY(QColor inactiveColor READ inactiveColor WRITE setInactiveColor NOTIFY inactiveColorChanged FINAL)
+    Q_PROPERTY(QMargins margins READ margins NOTIFY marginsChanged FINAL)
+
+public:
+    explicit WindowShadowPainter(QObject *parent = nullptr);
+    ~WindowShadowPainter() override;
+
+    Q_NODISCARD int radius() const;
+    Q_NODISCARD int cornerRadius() const;
+    Q_NODISCARD QColor activeColor() const;
+    Q_NODISCARD QColor inactiveColor() const;
+    Q_NODISCARD QMargins margins() const;
+    Q_NODISCARD QWindow *window() const;
+
+public Q_SLOTS:
+    void paint(QPainter *painter, const QSize &size, const bool active) const;
+    void setRadius(const int value);
+    void setCornerRadius(const int value);
+    void setActiveColor(const QColor &value);
+    void setInactiveColor(const QColor &value);
+    void setWindow(QWindow *value);
+
+Q_SIGNALS:
+    void radiusChanged();
+    void cornerRadiusChanged();
+    void activeColorChanged();
+    void inactiveColorChanged();
+    void marginsChanged();
+    void windowChanged();
+    void shouldRepaint();
+
+private:
+    QScopedPointer<WindowShadowPainterPrivate> d_ptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
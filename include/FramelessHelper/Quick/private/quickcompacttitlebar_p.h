@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qvariant.h>
+#include <QtGui/qfont.h>
+#include <QtGui/qglyphrun.h>
+#include <QtGui/qimage.h>
+#include <array>
+#include <optional>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+class QQuickWindow;
+class QSGNode;
+class QMouseEvent;
+QT_END_NAMESPACE
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class QuickCompactTitleBar;
+class QuickChromePalette;
+
+class FRAMELESSHELPER_QUICK_API QuickCompactTitleBarPrivate : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(QuickCompactTitleBarPrivate)
+    Q_DECLARE_PUBLIC(QuickCompactTitleBar)
+
+public:
+#ifdef Q_OS_MACOS
+    static constexpr const int kButtonCount = 0;
+#else // !Q_OS_MACOS
+    static constexpr const int kButtonCount = 3;
+#endif // Q_OS_MACOS
+
+    struct TitleLayout
+    {
+        QString text = {};
+        QFont font = {};
+        qreal availableWidth = 0.0;
+        QList<QGlyphRun> glyphRuns = {};
+        QSizeF size = {};
+        quint64 serial = 0;
+    };
+
+    struct RasterizedImage
+    {
+        QImage image = {};
+        // Whatever the image was generated from, to know when it needs to be regenerated.
+        qint64 sourceKey = 0;
+    };
+
+    explicit QuickCompactTitleBarPrivate(QuickCompactTitleBar *q);
+    ~QuickCompactTitleBarPrivate() override;
+
+    Q_NODISCARD static QuickCompactTitleBarPrivate *get(QuickCompactTitleBar *q);
+    Q_NODISCARD static const QuickCompactTitleBarPrivate *get(const QuickCompactTitleBar *q);
+
+    Q_NODISCARD QFont titleFont() const;
+    Q_NODISCARD bool isActive() const;
+    Q_NODISCARD qreal devicePixelRatio() const;
+
+    Q_NODISCARD QuickGlobal::SystemButtonType buttonType(const int index) const;
+    Q_NODISCARD QRectF buttonRect(const int index) const;
+    Q_NODISCARD int buttonAt(const QPointF &pos) const;
+    Q_NODISCARD QRectF windowIconRect() const;
+    Q_NODISCARD bool windowIconVisible_real() const;
+    Q_NODISCARD std::pair<qreal, qreal> titleBounds() const;
+    Q_NODISCARD QRectF titleRect() const;
+    Q_NODISCARD bool isInTitleBarIconArea(const QPointF &pos) const;
+
+    void rasterize();
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *oldNode);
+
+    void setHoveredButton(const int index);
+    void setPressedButton(const int index);
+    void mouseReleaseHandler(QMouseEvent *event);
+    Q_NODISCARD bool mouseDoubleClickHandler(QMouseEvent *event);
+
+public Q_SLOTS:
+    void invalidate();
+    void updateHitTestRects();
+    void rebindWindow(QQuickWindow *window);
+    void clickButton(const int index);
+
+private:
+    void initialize();
+    void rasterizeTitle(const qreal dpr);
+    void rasterizeWindowIcon(const qreal dpr);
+    void rasterizeButtons(const qreal dpr);
+
+private:
+    QuickCompactTitleBar *q_ptr = nullptr;
+    QPointer<QQuickWindow> m_window = nullptr;
+    QMetaObject::Connection m_windowStateChangeConnection = {};
+    QMetaObject::Connection m_windowActiveChangeConnection = {};
+    QMetaObject::Connection m_windowTitleChangeConnection = {};
+    QuickChromePalette *m_chromePalette = nullptr;
+    Qt::Alignment m_labelAlignment = {};
+    std::optional<QFont> m_titleFont = std::nullopt;
+    bool m_extended = false;
+    bool m_hideWhenClose = false;
+    QSizeF m_windowIconSize = {};
+    bool m_windowIconVisible = false;
+    QVariant m_windowIcon = {};
+    int m_hoveredButton = -1;
+    int m_pressedButton = -1;
+    bool m_closeTriggered = false;
+    QList<QRect> m_hitTestVisibleRects = {};
+    // Prepared on the GUI thread in updatePolish(), only uploaded in updatePaintNode().
+    std::optional<TitleLayout> m_titleLayout = std::nullopt;
+    RasterizedImage m_titleImage = {};
+    RasterizedImage m_windowIconImage = {};
+    std::array<RasterizedImage, 3> m_buttonImages = {};
+    quint64 m_windowIconSerial = 0;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -57,10 +57,12 @@ private:
     void fromPixmap(const QPixmap &value, QPainter *painter) const;
     void fromIcon(const QIcon &value, QPainter *painter) const;
     Q_NODISCARD QRectF paintArea() const;
+    void updateMemoryUsage() const;
 
 private:
     QuickImageItem *q_ptr = nullptr;
     QVariant m_source = {};
+    mutable qint64 m_memoryUsage = 0;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -33,6 +33,7 @@
 QT_BEGIN_NAMESPACE
 class QQuickText;
 class QQuickRectangle;
+class QQuickToolTipAttached;
 QT_END_NAMESPACE
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
@@ -52,6 +53,7 @@ class FRAMELESSHELPER_QUICK_API QuickStandardSystemButton : public QQuickButton
     Q_PROPERTY(QColor activeForegroundColor READ activeForegroundColor WRITE setActiveForegroundColor NOTIFY activeForegroundColorChanged FINAL)
     Q_PROPERTY(QColor inactiveForegroundColor READ inactiveForegroundColor WRITE setInactiveForegroundColor NOTIFY inactiveForegroundColorChanged FINAL)
     Q_PROPERTY(qreal iconSize READ iconSize WRITE setIconSize NOTIFY iconSizeChanged FINAL)
+    Q_PROPERTY(QString toolTip READ toolTip WRITE setToolTip NOTIFY toolTipChanged FINAL)
 
 public:
     explicit QuickStandardSystemButton(QQuickItem *parent = nullptr);
@@ -66,6 +68,7 @@ public:
     Q_NODISCARD QColor activeForegroundColor() const;
     Q_NODISCARD QColor inactiveForegroundColor() const;
     Q_NODISCARD qreal iconSize() const;
+    Q_NODISCARD QString toolTip() const;
 
 public Q_SLOTS:
     void updateColor();
@@ -77,6 +80,7 @@ public Q_SLOTS:
     void setActiveForegroundColor(const QColor &value);
     void setInactiveForegroundColor(const QColor &value);
     void setIconSize(const qreal value);
+    void setToolTip(const QString &value);
 
 protected:
     void classBegin() override;
@@ -84,6 +88,7 @@ protected:
 
 private:
     void initialize();
+    Q_NODISCARD QQuickToolTipAttached *toolTipAttached(const bool create) const;
 
 Q_SIGNALS:
     void buttonTypeChanged();
@@ -94,6 +99,7 @@ Q_SIGNALS:
     void activeForegroundColorChanged();
     void inactiveForegroundColorChanged();
     void iconSizeChanged();
+    void toolTipChanged();
 
 private:
     QQuickText *m_contentItem = nullptr;
@@ -105,6 +111,7 @@ private:
     QColor m_pressColor = {};
     QColor m_activeForegroundColor = {};
     QColor m_inactiveForegroundColor = {};
+    QString m_toolTip = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
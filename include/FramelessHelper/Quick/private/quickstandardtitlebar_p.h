@@ -104,6 +104,7 @@ private Q_SLOTS:
     void updateTitleLabelText();
     void updateTitleBarColor();
     void updateChromeButtonColor();
+    void updateColors();
     void clickMinimizeButton();
     void clickMaximizeButton();
     void clickCloseButton();
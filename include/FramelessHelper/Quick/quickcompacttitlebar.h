@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <FramelessHelper/Quick/framelesshelperquick_global.h>
+#include <QtGui/qfont.h>
+#include <QtQuick/qquickitem.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+class QuickChromePalette;
+class QuickCompactTitleBarPrivate;
+
+class FRAMELESSHELPER_QUICK_API QuickCompactTitleBar : public QQuickItem
+{
+    Q_OBJECT
+#ifdef QML_NAMED_ELEMENT
+    QML_NAMED_ELEMENT(CompactTitleBar)
+#endif
+    Q_DISABLE_COPY_MOVE(QuickCompactTitleBar)
+    Q_DECLARE_PRIVATE(QuickCompactTitleBar)
+
+    Q_PROPERTY(Qt::Alignment titleLabelAlignment READ titleLabelAlignment WRITE setTitleLabelAlignment NOTIFY titleLabelAlignmentChanged FINAL)
+    Q_PROPERTY(QFont titleFont READ titleFont WRITE setTitleFont NOTIFY titleFontChanged FINAL)
+    Q_PROPERTY(bool extended READ isExtended WRITE setExtended NOTIFY extendedChanged FINAL)
+    Q_PROPERTY(bool hideWhenClose READ isHideWhenClose WRITE setHideWhenClose NOTIFY hideWhenCloseChanged FINAL)
+    Q_PROPERTY(QuickChromePalette* chromePalette READ chromePalette CONSTANT FINAL)
+    Q_PROPERTY(QSizeF windowIconSize READ windowIconSize WRITE setWindowIconSize NOTIFY windowIconSizeChanged FINAL)
+    Q_PROPERTY(bool windowIconVisible READ windowIconVisible WRITE setWindowIconVisible NOTIFY windowIconVisibleChanged FINAL)
+    Q_PROPERTY(QVariant windowIcon READ windowIcon WRITE setWindowIcon NOTIFY windowIconChanged FINAL)
+
+public:
+    explicit QuickCompactTitleBar(QQuickItem *parent = nullptr);
+    ~QuickCompactTitleBar() override;
+
+    Q_NODISCARD Qt::Alignment titleLabelAlignment() const;
+    void setTitleLabelAlignment(const Qt::Alignment value);
+
+    Q_NODISCARD QFont titleFont() const;
+    void setTitleFont(const QFont &value);
+
+    Q_NODISCARD bool isExtended() const;
+    void setExtended(const bool value);
+
+    Q_NODISCARD bool isHideWhenClose() const;
+    void setHideWhenClose(const bool value);
+
+    Q_NODISCARD QuickChromePalette *chromePalette() const;
+
+    Q_NODISCARD QSizeF windowIconSize() const;
+    void setWindowIconSize(const QSizeF &value);
+
+    Q_NODISCARD bool windowIconVisible() const;
+    void setWindowIconVisible(const bool value);
+
+    Q_NODISCARD QVariant windowIcon() const;
+    void setWindowIcon(const QVariant &value);
+
+protected:
+    Q_NODISCARD QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void updatePolish() override;
+    void itemChange(const ItemChange change, const ItemChangeData &value) override;
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    void hoverMoveEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void mouseUngrabEvent() override;
+    void classBegin() override;
+    void componentComplete() override;
+
+Q_SIGNALS:
+    void titleLabelAlignmentChanged();
+    void titleFontChanged();
+    void extendedChanged();
+    void hideWhenCloseChanged();
+    void windowIconSizeChanged();
+    void windowIconVisibleChanged();
+    void windowIconChanged();
+
+private:
+    QScopedPointer<QuickCompactTitleBarPrivate> d_ptr;
+};
+
+FRAMELESSHELPER_END_NAMESPACE
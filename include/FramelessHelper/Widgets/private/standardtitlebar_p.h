@@ -26,6 +26,8 @@
 
 #include <FramelessHelper/Widgets/framelesshelperwidgets_global.h>
 #include <QtGui/qfont.h>
+#include <QtGui/qpixmap.h>
+#include <QtGui/qstatictext.h>
 #include <optional>
 
 QT_BEGIN_NAMESPACE
@@ -53,6 +55,21 @@ public:
         int ascent = 0;
     };
 
+    struct TitleLabelCache
+    {
+        QString text = {};
+        QFont font = {};
+        FontMetrics metrics = {};
+        QStaticText staticText = {};
+    };
+
+    struct WindowIconCache
+    {
+        QSize size = {};
+        qreal devicePixelRatio = 0.0;
+        QPixmap pixmap = {};
+    };
+
     explicit StandardTitleBarPrivate(StandardTitleBar *q);
     ~StandardTitleBarPrivate() override;
 
@@ -92,11 +109,16 @@ public:
 
     Q_NODISCARD QFont defaultFont() const;
     Q_NODISCARD FontMetrics titleLabelSize() const;
+    Q_NODISCARD const TitleLabelCache *titleLabelCache() const;
+    Q_NODISCARD QPixmap windowIconPixmap() const;
+    void invalidateTitleLabelCache();
+    void invalidateWindowIconCache();
 
 public Q_SLOTS:
     void updateMaximizeButton();
     void updateTitleBarColor();
     void updateChromeButtonColor();
+    void updateColors();
     void retranslateUi();
 
 protected:
@@ -122,6 +144,8 @@ private:
     bool m_windowIconVisible = false;
     std::optional<QFont> m_titleFont = std::nullopt;
     bool m_closeTriggered = false;
+    mutable std::optional<TitleLabelCache> m_titleLabelCache = std::nullopt;
+    mutable std::optional<WindowIconCache> m_windowIconCache = std::nullopt;
 };
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -31,6 +31,7 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 class MicaMaterial;
 class WindowBorderPainter;
+class WindowShadowPainter;
 
 class FRAMELESSHELPER_WIDGETS_API WidgetsSharedHelper : public QObject
 {
@@ -49,6 +50,10 @@ public:
 
     Q_NODISCARD MicaMaterial *rawMicaMaterial() const;
     Q_NODISCARD WindowBorderPainter *rawWindowBorder() const;
+    Q_NODISCARD WindowShadowPainter *rawWindowShadow() const;
+
+    // Picks up the shadow the Qt backend attached to the window, if any.
+    void updateWindowShadow();
 
 protected:
     Q_NODISCARD bool eventFilter(QObject *object, QEvent *event) override;
@@ -58,7 +63,11 @@ private Q_SLOTS:
     void handleScreenChanged(QScreen *screen);
 
 private:
+    Q_NODISCARD QMargins shadowMargins() const;
+    Q_NODISCARD QRect shadowlessRect() const;
+    void repaintShadow();
     void repaintMica();
+    void updateCornerOverlay();
     void repaintBorder();
     void emitCustomWindowStateSignals();
 
@@ -76,6 +85,10 @@ private:
     WindowBorderPainter *m_borderPainter = nullptr;
     QMetaObject::Connection m_borderRepaintConnection = {};
     QMetaObject::Connection m_screenChangeConnection = {};
+    QPointer<QWidget> m_cornerOverlay;
+    QPointer<WindowShadowPainter> m_shadowPainter;
+    QMetaObject::Connection m_shadowRepaintConnection = {};
+    QMetaObject::Connection m_shadowMarginsConnection = {};
 };
 
 FRAMELESSHELPER_END_NAMESPACE
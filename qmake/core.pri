@@ -33,15 +33,23 @@ HEADERS += \
     $$CORE_PUB_INC_DIR/micamaterial.h \
     $$CORE_PUB_INC_DIR/utils.h \
     $$CORE_PUB_INC_DIR/windowborderpainter.h \
+    $$CORE_PUB_INC_DIR/windowshadowpainter.h \
+    $$CORE_PUB_INC_DIR/wallpapersource.h \
     $$CORE_PRIV_INC_DIR/chromepalette_p.h \
     $$CORE_PRIV_INC_DIR/framelessconfig_p.h \
     $$CORE_PRIV_INC_DIR/framelessmanager_p.h \
     $$CORE_PRIV_INC_DIR/micamaterial_p.h \
     $$CORE_PRIV_INC_DIR/sysapiloader_p.h \
     $$CORE_PRIV_INC_DIR/windowborderpainter_p.h \
+    $$CORE_PRIV_INC_DIR/windowshadowpainter_p.h \
+    $$CORE_PRIV_INC_DIR/windowcornermask_p.h \
+    $$CORE_PRIV_INC_DIR/framethrottle_p.h \
     $$CORE_PRIV_INC_DIR/framelesshelpercore_global_p.h \
     $$CORE_PRIV_INC_DIR/versionnumber_p.h \
-    $$CORE_PRIV_INC_DIR/scopeguard_p.h
+    $$CORE_PRIV_INC_DIR/scopeguard_p.h \
+    $$CORE_PRIV_INC_DIR/tracing_p.h \
+    $$CORE_PRIV_INC_DIR/statistics_p.h \
+    $$CORE_PRIV_INC_DIR/cachebudget_p.h
 
 SOURCES += \
     $$CORE_SRC_DIR/chromepalette.cpp \
@@ -52,7 +60,14 @@ SOURCES += \
     $$CORE_SRC_DIR/micamaterial.cpp \
     $$CORE_SRC_DIR/sysapiloader.cpp \
     $$CORE_SRC_DIR/utils.cpp \
-    $$CORE_SRC_DIR/windowborderpainter.cpp
+    $$CORE_SRC_DIR/windowborderpainter.cpp \
+    $$CORE_SRC_DIR/windowshadowpainter.cpp \
+    $$CORE_SRC_DIR/windowcornermask.cpp \
+    $$CORE_SRC_DIR/framethrottle.cpp \
+    $$CORE_SRC_DIR/wallpapersource.cpp \
+    $$CORE_SRC_DIR/tracing.cpp \
+    $$CORE_SRC_DIR/statistics.cpp \
+    $$CORE_SRC_DIR/cachebudget.cpp
 
 RESOURCES += \
     $$CORE_SRC_DIR/framelesshelpercore.qrc
@@ -77,10 +92,18 @@ unix:!macx {
     PKGCONFIG += xcb gtk+-3.0
     DEFINES += GDK_VERSION_MIN_REQUIRED=GDK_VERSION_3_6
     HEADERS += \
-        $$CORE_PUB_INC_DIR/framelesshelper_linux.h
+        $$CORE_PUB_INC_DIR/framelesshelper_linux.h \
+        $$CORE_PRIV_INC_DIR/desktopportalsettings_p.h \
+        $$CORE_PRIV_INC_DIR/desktopwallpaperwatcher_p.h
     SOURCES += \
         $$CORE_SRC_DIR/utils_linux.cpp \
-        $$CORE_SRC_DIR/platformsupport_linux.cpp
+        $$CORE_SRC_DIR/platformsupport_linux.cpp \
+        $$CORE_SRC_DIR/desktopportalsettings.cpp \
+        $$CORE_SRC_DIR/desktopwallpaperwatcher.cpp
+    qtHaveModule(dbus) {
+        QT += dbus
+        DEFINES += FRAMELESSHELPER_HAS_DBUS
+    }
 }
 
 macx {
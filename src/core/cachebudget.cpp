@@ -0,0 +1,244 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "cachebudget_p.h"
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <array>
+#include <limits>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcCacheBudget, "wangwenx190.framelesshelper.core.cachebudget")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcCacheBudget)
+#  define DEBUG qCDebug(lcCacheBudget)
+#  define WARNING qCWarning(lcCacheBudget)
+#  define CRITICAL qCCritical(lcCacheBudget)
+#endif
+
+using namespace Global;
+
+static constexpr const auto kCacheCount = (int(CacheBudget::Cache::Last) + 1);
+
+// The caches which are the cheapest to rebuild come first. The others either hold
+// something that can't be recreated (the icon font) or are owned by somebody else.
+static constexpr const std::array<CacheBudget::Cache, 3> kTrimOrder =
+{
+    CacheBudget::Cache::Glyphs,
+    CacheBudget::Cache::Shadows,
+    CacheBudget::Cache::Wallpapers
+};
+
+struct CacheBudgetData
+{
+    QMutex mutex{};
+    qint64 budget = 0;
+    std::array<qint64, kCacheCount> usages = {};
+    std::array<CacheBudget::Trimmer, kCacheCount> trimmers = {};
+    bool enforcePending = false;
+    bool warned = false;
+};
+
+Q_GLOBAL_STATIC(CacheBudgetData, g_cacheBudgetData)
+
+[[nodiscard]] static inline qint64 totalUsage_unlocked()
+{
+    qint64 total = 0;
+    for (auto &&usage : std::as_const(g_cacheBudgetData()->usages)) {
+        total += usage;
+    }
+    return total;
+}
+
+CacheBudget::CacheBudget(QObject *parent) : QObject(parent)
+{
+    // The trimmers must run on the main thread, no matter who asked for us first.
+    if (const QCoreApplication * const app = QCoreApplication::instance()) {
+        if (thread() != app->thread()) {
+            moveToThread(app->thread());
+        }
+    }
+}
+
+CacheBudget::~CacheBudget() = default;
+
+CacheBudget *CacheBudget::instance()
+{
+    static CacheBudget budget;
+    return &budget;
+}
+
+qint64 CacheBudget::budget() const
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    return g_cacheBudgetData()->budget;
+}
+
+void CacheBudget::setBudget(const qint64 bytes)
+{
+    {
+        const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+        const qint64 value = qMax(qint64(0), bytes);
+        if (g_cacheBudgetData()->budget == value) {
+            return;
+        }
+        g_cacheBudgetData()->budget = value;
+        g_cacheBudgetData()->warned = false;
+    }
+    scheduleEnforce();
+}
+
+void CacheBudget::setUsage(const Cache cache, const qint64 bytes)
+{
+    {
+        const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+        qint64 &usage = g_cacheBudgetData()->usages.at(int(cache));
+        const qint64 value = qMax(qint64(0), bytes);
+        // Nothing changed, don't bother the trimmers again.
+        if (usage == value) {
+            return;
+        }
+        usage = value;
+    }
+    scheduleEnforce();
+}
+
+void CacheBudget::addUsage(const Cache cache, const qint64 delta)
+{
+    {
+        const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+        qint64 &usage = g_cacheBudgetData()->usages.at(int(cache));
+        usage = qMax(qint64(0), (usage + delta));
+    }
+    if (delta > 0) {
+        scheduleEnforce();
+    }
+}
+
+qint64 CacheBudget::usage(const Cache cache) const
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    return g_cacheBudgetData()->usages.at(int(cache));
+}
+
+qint64 CacheBudget::totalUsage() const
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    return totalUsage_unlocked();
+}
+
+qint64 CacheBudget::available() const
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    if (g_cacheBudgetData()->budget <= 0) {
+        return std::numeric_limits<qint64>::max();
+    }
+    return qMax(qint64(0), (g_cacheBudgetData()->budget - totalUsage_unlocked()));
+}
+
+CacheMemoryUsage CacheBudget::snapshot() const
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    const auto &usages = g_cacheBudgetData()->usages;
+    CacheMemoryUsage result = {};
+    result.wallpapers = quint64(usages.at(int(Cache::Wallpapers)));
+    result.materialBrushes = quint64(usages.at(int(Cache::MaterialBrushes)));
+    result.iconFont = quint64(usages.at(int(Cache::IconFont)));
+    result.glyphs = quint64(usages.at(int(Cache::Glyphs)));
+    result.images = quint64(usages.at(int(Cache::Images)));
+    result.shadows = quint64(usages.at(int(Cache::Shadows)));
+    result.total = quint64(totalUsage_unlocked());
+    result.budget = quint64(g_cacheBudgetData()->budget);
+    return result;
+}
+
+void CacheBudget::setTrimmer(const Cache cache, const Trimmer &trimmer)
+{
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    g_cacheBudgetData()->trimmers.at(int(cache)) = trimmer;
+}
+
+void CacheBudget::scheduleEnforce()
+{
+    {
+        const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+        const qint64 budget = g_cacheBudgetData()->budget;
+        if ((budget <= 0) || (totalUsage_unlocked() <= budget)) {
+            g_cacheBudgetData()->warned = false;
+            return;
+        }
+        if (g_cacheBudgetData()->enforcePending) {
+            return;
+        }
+        g_cacheBudgetData()->enforcePending = true;
+    }
+    // The caches are reported from the wallpaper thread as well, always trim from the main thread.
+    QMetaObject::invokeMethod(this, "enforce", Qt::QueuedConnection);
+}
+
+void CacheBudget::enforce()
+{
+    Q_ASSERT(QThread::currentThread() == thread());
+    for (auto &&cache : std::as_const(kTrimOrder)) {
+        qint64 excess = 0;
+        Trimmer trimmer = nullptr;
+        {
+            const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+            g_cacheBudgetData()->enforcePending = false;
+            const qint64 budget = g_cacheBudgetData()->budget;
+            if (budget <= 0) {
+                return;
+            }
+            excess = (totalUsage_unlocked() - budget);
+            if (excess <= 0) {
+                g_cacheBudgetData()->warned = false;
+                return;
+            }
+            trimmer = g_cacheBudgetData()->trimmers.at(int(cache));
+        }
+        // Don't hold our lock here, the trimmers will report their new usage to us.
+        if (trimmer) {
+            trimmer(excess);
+        }
+    }
+    const QMutexLocker locker(&g_cacheBudgetData()->mutex);
+    const qint64 budget = g_cacheBudgetData()->budget;
+    const qint64 total = totalUsage_unlocked();
+    // Some of the caches shrink asynchronously, so this may not be the final state yet.
+    if ((budget > 0) && (total > budget) && !g_cacheBudgetData()->warned) {
+        g_cacheBudgetData()->warned = true;
+        DEBUG << "The image caches are still holding" << total << "bytes, which is over the budget of" << budget << "bytes.";
+    }
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/cachebudget_p.h"
@@ -27,6 +27,7 @@
 #include "framelessmanager.h"
 #include "utils.h"
 #include <QtCore/qloggingcategory.h>
+#include <memory>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -46,6 +47,92 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+[[nodiscard]] static inline ChromePalettePrivate::ColorsPtr calculateSystemColors()
+{
+    const auto colors = std::make_shared<ChromePalettePrivate::Colors>();
+    const bool colorized = Utils::isTitleBarColorized();
+    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
+    colors->titleBarActiveBackgroundColor = [colorized, dark]() -> QColor {
+        if (colorized) {
+            return Utils::getAccentColor();
+        } else {
+            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
+        }
+    }();
+    colors->titleBarInactiveBackgroundColor = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
+    colors->titleBarActiveForegroundColor = [&colors, dark, colorized]() -> QColor {
+        if (dark || colorized) {
+            // Calculate the most appropriate foreground color, based on the
+            // current background color.
+            const qreal grayF = (
+                (qreal(0.299) * colors->titleBarActiveBackgroundColor.redF()) +
+                (qreal(0.587) * colors->titleBarActiveBackgroundColor.greenF()) +
+                (qreal(0.114) * colors->titleBarActiveBackgroundColor.blueF()));
+            static constexpr const auto kFlag = qreal(0.5);
+            if ((grayF < kFlag) || qFuzzyCompare(grayF, kFlag)) {
+                return kDefaultWhiteColor;
+            }
+        }
+        return kDefaultBlackColor;
+    }();
+    colors->titleBarInactiveForegroundColor = kDefaultDarkGrayColor;
+    colors->chromeButtonNormalColor = kDefaultTransparentColor;
+    colors->chromeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
+    colors->chromeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
+    colors->closeButtonNormalColor = kDefaultTransparentColor;
+    colors->closeButtonHoverColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
+    colors->closeButtonPressColor =
+        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    return colors;
+}
+
+// The system colors only depend on the global system theme, so there's no need to let
+// every palette query the system and calculate the exact same colors again and again.
+// This object does it once per theme change and then tells all the palettes about it.
+class ChromePaletteSharedData : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ChromePaletteSharedData)
+
+public:
+    explicit ChromePaletteSharedData(QObject *parent = nullptr) : QObject(parent)
+    {
+        m_colors = calculateSystemColors();
+        connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged,
+            this, &ChromePaletteSharedData::refresh);
+    }
+
+    ~ChromePaletteSharedData() override = default;
+
+    [[nodiscard]] ChromePalettePrivate::ColorsPtr colors() const
+    {
+        return m_colors;
+    }
+
+Q_SIGNALS:
+    void colorsChanged();
+
+public Q_SLOTS:
+    void refresh()
+    {
+        m_colors = calculateSystemColors();
+        Q_EMIT colorsChanged();
+    }
+
+private:
+    ChromePalettePrivate::ColorsPtr m_colors = nullptr;
+};
+
+[[nodiscard]] static inline ChromePaletteSharedData *chromePaletteSharedData()
+{
+    // Let the manager own it, so that it won't outlive the manager it connects to.
+    static const auto data = new ChromePaletteSharedData(FramelessManager::instance());
+    return data;
+}
+
 ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -53,8 +140,8 @@ ChromePalettePrivate::ChromePalettePrivate(ChromePalette *q) : QObject(q)
         return;
     }
     q_ptr = q;
-    connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged, this, &ChromePalettePrivate::refresh);
-    refresh();
+    sys = systemColors();
+    connect(chromePaletteSharedData(), &ChromePaletteSharedData::colorsChanged, this, &ChromePalettePrivate::refresh);
 }
 
 ChromePalettePrivate::~ChromePalettePrivate() = default;
@@ -77,57 +164,54 @@ const ChromePalettePrivate *ChromePalettePrivate::get(const ChromePalette *q)
     return q->d_func();
 }
 
+ChromePalettePrivate::ColorsPtr ChromePalettePrivate::systemColors()
+{
+    return chromePaletteSharedData()->colors();
+}
+
+void ChromePalettePrivate::refreshSystemColors()
+{
+    chromePaletteSharedData()->refresh();
+}
+
 void ChromePalettePrivate::refresh()
 {
-    const bool colorized = Utils::isTitleBarColorized();
-    const bool dark = (FramelessManager::instance()->systemTheme() == SystemTheme::Dark);
-    titleBarActiveBackgroundColor_sys = [colorized, dark]() -> QColor {
-        if (colorized) {
-            return Utils::getAccentColor();
-        } else {
-            return (dark ? kDefaultBlackColor : kDefaultWhiteColor);
-        }
-    }();
-    titleBarInactiveBackgroundColor_sys = (dark ? kDefaultSystemDarkColor : kDefaultWhiteColor);
-    titleBarActiveForegroundColor_sys = [this, dark, colorized]() -> QColor {
-        if (dark || colorized) {
-            // Calculate the most appropriate foreground color, based on the
-            // current background color.
-            const qreal grayF = (
-                (qreal(0.299) * titleBarActiveBackgroundColor_sys.redF()) +
-                (qreal(0.587) * titleBarActiveBackgroundColor_sys.greenF()) +
-                (qreal(0.114) * titleBarActiveBackgroundColor_sys.blueF()));
-            static constexpr const auto kFlag = qreal(0.5);
-            if ((grayF < kFlag) || qFuzzyCompare(grayF, kFlag)) {
-                return kDefaultWhiteColor;
-            }
-        }
-        return kDefaultBlackColor;
-    }();
-    titleBarInactiveForegroundColor_sys = kDefaultDarkGrayColor;
-    chromeButtonNormalColor_sys = kDefaultTransparentColor;
-    chromeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Hovered);
-    chromeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Minimize, ButtonState::Pressed);
-    closeButtonNormalColor_sys = kDefaultTransparentColor;
-    closeButtonHoverColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Hovered);
-    closeButtonPressColor_sys =
-        Utils::calculateSystemButtonBackgroundColor(SystemButtonType::Close, ButtonState::Pressed);
+    const ColorsPtr oldColors = sys;
+    sys = systemColors();
+    if (sys == oldColors) {
+        return;
+    }
     Q_Q(ChromePalette);
-    Q_EMIT q->titleBarActiveBackgroundColorChanged();
-    Q_EMIT q->titleBarInactiveBackgroundColorChanged();
-    Q_EMIT q->titleBarActiveForegroundColorChanged();
-    Q_EMIT q->titleBarInactiveForegroundColorChanged();
-    Q_EMIT q->chromeButtonNormalColorChanged();
-    Q_EMIT q->chromeButtonHoverColorChanged();
-    Q_EMIT q->chromeButtonPressColorChanged();
-    Q_EMIT q->closeButtonNormalColorChanged();
-    Q_EMIT q->closeButtonHoverColorChanged();
-    Q_EMIT q->closeButtonPressColorChanged();
-    Q_EMIT q->titleBarColorChanged();
-    Q_EMIT q->chromeButtonColorChanged();
+    bool titleBarChanged = false;
+    bool chromeButtonChanged = false;
+    // Only notify the colors that really changed, the ones overrided by the user
+    // stay the same no matter what the system theme is. Each group signal and
+    // paletteChanged() is emitted at most once per refresh.
+#define NOTIFY_IF_CHANGED(Name, Group) \
+    if (!Name.has_value() && (oldColors->Name != sys->Name)) { \
+        Q_EMIT q->Name##Changed(); \
+        Group = true; \
+    }
+    NOTIFY_IF_CHANGED(titleBarActiveBackgroundColor, titleBarChanged)
+    NOTIFY_IF_CHANGED(titleBarInactiveBackgroundColor, titleBarChanged)
+    NOTIFY_IF_CHANGED(titleBarActiveForegroundColor, titleBarChanged)
+    NOTIFY_IF_CHANGED(titleBarInactiveForegroundColor, titleBarChanged)
+    NOTIFY_IF_CHANGED(chromeButtonNormalColor, chromeButtonChanged)
+    NOTIFY_IF_CHANGED(chromeButtonHoverColor, chromeButtonChanged)
+    NOTIFY_IF_CHANGED(chromeButtonPressColor, chromeButtonChanged)
+    NOTIFY_IF_CHANGED(closeButtonNormalColor, chromeButtonChanged)
+    NOTIFY_IF_CHANGED(closeButtonHoverColor, chromeButtonChanged)
+    NOTIFY_IF_CHANGED(closeButtonPressColor, chromeButtonChanged)
+#undef NOTIFY_IF_CHANGED
+    if (titleBarChanged) {
+        Q_EMIT q->titleBarColorChanged();
+    }
+    if (chromeButtonChanged) {
+        Q_EMIT q->chromeButtonColorChanged();
+    }
+    if (titleBarChanged || chromeButtonChanged) {
+        Q_EMIT q->paletteChanged();
+    }
 }
 
 ChromePalette::ChromePalette(QObject *parent) :
@@ -140,61 +224,61 @@ ChromePalette::~ChromePalette() = default;
 QColor ChromePalette::titleBarActiveBackgroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarActiveBackgroundColor.value_or(d->titleBarActiveBackgroundColor_sys);
+    return d->titleBarActiveBackgroundColor.value_or(d->sys->titleBarActiveBackgroundColor);
 }
 
 QColor ChromePalette::titleBarInactiveBackgroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarInactiveBackgroundColor.value_or(d->titleBarInactiveBackgroundColor_sys);
+    return d->titleBarInactiveBackgroundColor.value_or(d->sys->titleBarInactiveBackgroundColor);
 }
 
 QColor ChromePalette::titleBarActiveForegroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarActiveForegroundColor.value_or(d->titleBarActiveForegroundColor_sys);
+    return d->titleBarActiveForegroundColor.value_or(d->sys->titleBarActiveForegroundColor);
 }
 
 QColor ChromePalette::titleBarInactiveForegroundColor() const
 {
     Q_D(const ChromePalette);
-    return d->titleBarInactiveForegroundColor.value_or(d->titleBarInactiveForegroundColor_sys);
+    return d->titleBarInactiveForegroundColor.value_or(d->sys->titleBarInactiveForegroundColor);
 }
 
 QColor ChromePalette::chromeButtonNormalColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonNormalColor.value_or(d->chromeButtonNormalColor_sys);
+    return d->chromeButtonNormalColor.value_or(d->sys->chromeButtonNormalColor);
 }
 
 QColor ChromePalette::chromeButtonHoverColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonHoverColor.value_or(d->chromeButtonHoverColor_sys);
+    return d->chromeButtonHoverColor.value_or(d->sys->chromeButtonHoverColor);
 }
 
 QColor ChromePalette::chromeButtonPressColor() const
 {
     Q_D(const ChromePalette);
-    return d->chromeButtonPressColor.value_or(d->chromeButtonPressColor_sys);
+    return d->chromeButtonPressColor.value_or(d->sys->chromeButtonPressColor);
 }
 
 QColor ChromePalette::closeButtonNormalColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonNormalColor.value_or(d->closeButtonNormalColor_sys);
+    return d->closeButtonNormalColor.value_or(d->sys->closeButtonNormalColor);
 }
 
 QColor ChromePalette::closeButtonHoverColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonHoverColor.value_or(d->closeButtonHoverColor_sys);
+    return d->closeButtonHoverColor.value_or(d->sys->closeButtonHoverColor);
 }
 
 QColor ChromePalette::closeButtonPressColor() const
 {
     Q_D(const ChromePalette);
-    return d->closeButtonPressColor.value_or(d->closeButtonPressColor_sys);
+    return d->closeButtonPressColor.value_or(d->sys->closeButtonPressColor);
 }
 
 void ChromePalette::setTitleBarActiveBackgroundColor(const QColor &value)
@@ -210,6 +294,7 @@ void ChromePalette::setTitleBarActiveBackgroundColor(const QColor &value)
     d->titleBarActiveBackgroundColor = value;
     Q_EMIT titleBarActiveBackgroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetTitleBarActiveBackgroundColor()
@@ -218,6 +303,7 @@ void ChromePalette::resetTitleBarActiveBackgroundColor()
     d->titleBarActiveBackgroundColor = std::nullopt;
     Q_EMIT titleBarActiveBackgroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setTitleBarInactiveBackgroundColor(const QColor &value)
@@ -233,6 +319,7 @@ void ChromePalette::setTitleBarInactiveBackgroundColor(const QColor &value)
     d->titleBarInactiveBackgroundColor = value;
     Q_EMIT titleBarInactiveBackgroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetTitleBarInactiveBackgroundColor()
@@ -241,6 +328,7 @@ void ChromePalette::resetTitleBarInactiveBackgroundColor()
     d->titleBarInactiveBackgroundColor = std::nullopt;
     Q_EMIT titleBarInactiveBackgroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setTitleBarActiveForegroundColor(const QColor &value)
@@ -256,6 +344,7 @@ void ChromePalette::setTitleBarActiveForegroundColor(const QColor &value)
     d->titleBarActiveForegroundColor = value;
     Q_EMIT titleBarActiveForegroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetTitleBarActiveForegroundColor()
@@ -264,6 +353,7 @@ void ChromePalette::resetTitleBarActiveForegroundColor()
     d->titleBarActiveForegroundColor = std::nullopt;
     Q_EMIT titleBarActiveForegroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setTitleBarInactiveForegroundColor(const QColor &value)
@@ -279,6 +369,7 @@ void ChromePalette::setTitleBarInactiveForegroundColor(const QColor &value)
     d->titleBarInactiveForegroundColor = value;
     Q_EMIT titleBarInactiveForegroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetTitleBarInactiveForegroundColor()
@@ -287,6 +378,7 @@ void ChromePalette::resetTitleBarInactiveForegroundColor()
     d->titleBarInactiveForegroundColor = std::nullopt;
     Q_EMIT titleBarInactiveForegroundColorChanged();
     Q_EMIT titleBarColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setChromeButtonNormalColor(const QColor &value)
@@ -302,6 +394,7 @@ void ChromePalette::setChromeButtonNormalColor(const QColor &value)
     d->chromeButtonNormalColor = value;
     Q_EMIT chromeButtonNormalColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetChromeButtonNormalColor()
@@ -310,6 +403,7 @@ void ChromePalette::resetChromeButtonNormalColor()
     d->chromeButtonNormalColor = std::nullopt;
     Q_EMIT chromeButtonNormalColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setChromeButtonHoverColor(const QColor &value)
@@ -325,6 +419,7 @@ void ChromePalette::setChromeButtonHoverColor(const QColor &value)
     d->chromeButtonHoverColor = value;
     Q_EMIT chromeButtonHoverColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetChromeButtonHoverColor()
@@ -333,6 +428,7 @@ void ChromePalette::resetChromeButtonHoverColor()
     d->chromeButtonHoverColor = std::nullopt;
     Q_EMIT chromeButtonHoverColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setChromeButtonPressColor(const QColor &value)
@@ -348,6 +444,7 @@ void ChromePalette::setChromeButtonPressColor(const QColor &value)
     d->chromeButtonPressColor = value;
     Q_EMIT chromeButtonPressColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetChromeButtonPressColor()
@@ -356,6 +453,7 @@ void ChromePalette::resetChromeButtonPressColor()
     d->chromeButtonPressColor = std::nullopt;
     Q_EMIT chromeButtonPressColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setCloseButtonNormalColor(const QColor &value)
@@ -371,6 +469,7 @@ void ChromePalette::setCloseButtonNormalColor(const QColor &value)
     d->closeButtonNormalColor = value;
     Q_EMIT closeButtonNormalColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetCloseButtonNormalColor()
@@ -379,6 +478,7 @@ void ChromePalette::resetCloseButtonNormalColor()
     d->closeButtonNormalColor = std::nullopt;
     Q_EMIT closeButtonNormalColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setCloseButtonHoverColor(const QColor &value)
@@ -394,6 +494,7 @@ void ChromePalette::setCloseButtonHoverColor(const QColor &value)
     d->closeButtonHoverColor = value;
     Q_EMIT closeButtonHoverColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetCloseButtonHoverColor()
@@ -402,6 +503,7 @@ void ChromePalette::resetCloseButtonHoverColor()
     d->closeButtonHoverColor = std::nullopt;
     Q_EMIT closeButtonHoverColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::setCloseButtonPressColor(const QColor &value)
@@ -417,6 +519,7 @@ void ChromePalette::setCloseButtonPressColor(const QColor &value)
     d->closeButtonPressColor = value;
     Q_EMIT closeButtonPressColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 void ChromePalette::resetCloseButtonPressColor()
@@ -425,6 +528,9 @@ void ChromePalette::resetCloseButtonPressColor()
     d->closeButtonPressColor = std::nullopt;
     Q_EMIT closeButtonPressColorChanged();
     Q_EMIT chromeButtonColorChanged();
+    Q_EMIT paletteChanged();
 }
 
 FRAMELESSHELPER_END_NAMESPACE
+
+#include "chromepalette.moc"
@@ -0,0 +1,263 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "desktopportalsettings_p.h"
+#include <QtCore/qloggingcategory.h>
+#ifdef FRAMELESSHELPER_HAS_DBUS
+#  include <QtDBus/qdbusconnection.h>
+#  include <QtDBus/qdbusmessage.h>
+#  include <QtDBus/qdbusvariant.h>
+#  include <QtDBus/qdbusargument.h>
+#  include <QtDBus/qdbuspendingcall.h>
+#endif // FRAMELESSHELPER_HAS_DBUS
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcDesktopPortalSettings, "wangwenx190.framelesshelper.core.desktopportalsettings")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcDesktopPortalSettings)
+#  define DEBUG qCDebug(lcDesktopPortalSettings)
+#  define WARNING qCWarning(lcDesktopPortalSettings)
+#  define CRITICAL qCCritical(lcDesktopPortalSettings)
+#endif
+
+using namespace Global;
+
+FRAMELESSHELPER_STRING_CONSTANT2(PortalService, "org.freedesktop.portal.Desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalPath, "/org/freedesktop/portal/desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalSettingsInterface, "org.freedesktop.portal.Settings")
+FRAMELESSHELPER_STRING_CONSTANT2(AppearanceNamespace, "org.freedesktop.appearance")
+FRAMELESSHELPER_STRING_CONSTANT2(ColorSchemeKey, "color-scheme")
+FRAMELESSHELPER_STRING_CONSTANT2(AccentColorKey, "accent-color")
+FRAMELESSHELPER_STRING_CONSTANT(ReadAll)
+FRAMELESSHELPER_STRING_CONSTANT(SettingChanged)
+
+// Give up on a portal which doesn't respond, the callers fall back to the GTK settings then.
+static constexpr const int kPortalCallTimeout = 1000; // ms
+
+class DesktopPortalSettingsListener : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(DesktopPortalSettingsListener)
+
+public:
+    explicit DesktopPortalSettingsListener(DesktopPortalSettings *settings)
+        : QObject(), m_settings(settings) {}
+    ~DesktopPortalSettingsListener() override = default;
+
+#ifdef FRAMELESSHELPER_HAS_DBUS
+public Q_SLOTS:
+    void handleSettingChanged(const QString &nameSpace, const QString &key, const QDBusVariant &value)
+    {
+        m_settings->handleSettingChanged(nameSpace, key, value.variant());
+    }
+#endif // FRAMELESSHELPER_HAS_DBUS
+
+private:
+    DesktopPortalSettings *m_settings = nullptr;
+};
+
+#ifdef FRAMELESSHELPER_HAS_DBUS
+[[nodiscard]] static inline QDBusConnection portalConnection(const QString &name)
+{
+    return (name.isEmpty() ? QDBusConnection::sessionBus() : QDBusConnection(name));
+}
+
+[[nodiscard]] static inline QVariant unwrapVariant(QVariant value)
+{
+    // Some portal implementations wrap the real value into one more variant than documented.
+    while (value.userType() == qMetaTypeId<QDBusVariant>()) {
+        value = qvariant_cast<QDBusVariant>(value).variant();
+    }
+    return value;
+}
+#endif // FRAMELESSHELPER_HAS_DBUS
+
+[[nodiscard]] static inline std::optional<DesktopPortalSettings::ColorScheme> toColorScheme(const QVariant &value)
+{
+    bool ok = false;
+    const uint scheme = value.toUInt(&ok);
+    if (!ok || (scheme > quint8(DesktopPortalSettings::ColorScheme::PreferLight))) {
+        return std::nullopt;
+    }
+    return static_cast<DesktopPortalSettings::ColorScheme>(scheme);
+}
+
+[[nodiscard]] static inline std::optional<QColor> toAccentColor(const QVariant &value)
+{
+#ifdef FRAMELESSHELPER_HAS_DBUS
+    if (value.userType() != qMetaTypeId<QDBusArgument>()) {
+        return std::nullopt;
+    }
+    const auto argument = qvariant_cast<QDBusArgument>(value);
+    double red = -1.0;
+    double green = -1.0;
+    double blue = -1.0;
+    argument.beginStructure();
+    argument >> red >> green >> blue;
+    argument.endStructure();
+    // Values out of the [0, 1] range mean the accent color is not set.
+    const auto inRange = [](const double channel) -> bool { return ((channel >= 0.0) && (channel <= 1.0)); };
+    if (!inRange(red) || !inRange(green) || !inRange(blue)) {
+        return std::nullopt;
+    }
+    return QColor::fromRgbF(red, green, blue);
+#else // !FRAMELESSHELPER_HAS_DBUS
+    Q_UNUSED(value);
+    return std::nullopt;
+#endif // FRAMELESSHELPER_HAS_DBUS
+}
+
+DesktopPortalSettings::DesktopPortalSettings(const QString &connectionName, QObject *parent)
+    : QObject(parent), m_connectionName(connectionName)
+{
+    initialize();
+}
+
+DesktopPortalSettings::~DesktopPortalSettings() = default;
+
+DesktopPortalSettings *DesktopPortalSettings::instance()
+{
+    static DesktopPortalSettings settings;
+    return &settings;
+}
+
+bool DesktopPortalSettings::isInitialized() const
+{
+    return m_initialized;
+}
+
+bool DesktopPortalSettings::isAvailable() const
+{
+    return m_available;
+}
+
+std::optional<DesktopPortalSettings::ColorScheme> DesktopPortalSettings::colorScheme() const
+{
+    return m_colorScheme;
+}
+
+std::optional<QColor> DesktopPortalSettings::accentColor() const
+{
+    return m_accentColor;
+}
+
+void DesktopPortalSettings::handleSettingChanged(const QString &nameSpace, const QString &key, const QVariant &value)
+{
+    if (nameSpace != kAppearanceNamespace) {
+        return;
+    }
+    if (key == kColorSchemeKey) {
+        const auto scheme = toColorScheme(value);
+        if (m_colorScheme == scheme) {
+            return;
+        }
+        m_colorScheme = scheme;
+        DEBUG << "Color scheme changed:" << m_colorScheme.value_or(ColorScheme::NoPreference);
+        Q_EMIT colorSchemeChanged();
+    } else if (key == kAccentColorKey) {
+        const auto color = toAccentColor(value);
+        if (m_accentColor == color) {
+            return;
+        }
+        m_accentColor = color;
+        DEBUG << "Accent color changed:" << m_accentColor.value_or(QColor{});
+        Q_EMIT accentColorChanged();
+    }
+}
+
+void DesktopPortalSettings::initialize()
+{
+    m_listener = std::make_unique<DesktopPortalSettingsListener>(this);
+#ifdef FRAMELESSHELPER_HAS_DBUS
+    QDBusConnection connection = portalConnection(m_connectionName);
+    if (!connection.isConnected()) {
+        WARNING << "The D-Bus session bus is not available.";
+        m_initialized = true;
+        return;
+    }
+    // Start listening before reading, so that no change can slip through in between.
+    if (!connection.connect(kPortalService, kPortalPath, kPortalSettingsInterface, kSettingChanged,
+            m_listener.get(), SLOT(handleSettingChanged(QString,QString,QDBusVariant)))) {
+        WARNING << "Failed to monitor the desktop portal settings change.";
+    }
+    // Never wait for the portal on the GUI thread, it may be slow to start or not exist at all.
+    QDBusMessage message = QDBusMessage::createMethodCall(kPortalService, kPortalPath, kPortalSettingsInterface, kReadAll);
+    message << QStringList{ kAppearanceNamespace };
+    const auto watcher = new QDBusPendingCallWatcher(connection.asyncCall(message, kPortalCallTimeout), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *self){
+        self->deleteLater();
+        m_initialized = true;
+        const QDBusMessage reply = self->reply();
+        const QVariantList arguments = reply.arguments();
+        if ((reply.type() != QDBusMessage::ReplyMessage) || arguments.isEmpty()
+            || (arguments.constFirst().userType() != qMetaTypeId<QDBusArgument>())) {
+            DEBUG << "Failed to read the appearance settings from the desktop portal:" << reply.errorMessage();
+            Q_EMIT initialized();
+            return;
+        }
+        // a{sa{sv}}: namespace -> (key -> value).
+        QVariantMap appearance = {};
+        const auto argument = qvariant_cast<QDBusArgument>(arguments.constFirst());
+        argument.beginMap();
+        while (!argument.atEnd()) {
+            QString nameSpace = {};
+            QVariantMap values = {};
+            argument.beginMapEntry();
+            argument >> nameSpace >> values;
+            argument.endMapEntry();
+            if (nameSpace == kAppearanceNamespace) {
+                appearance = values;
+            }
+        }
+        argument.endMap();
+        if (!appearance.contains(kColorSchemeKey)) {
+            // The portal doesn't implement the appearance settings, which is
+            // as good as no portal at all, just keep using the GTK settings.
+            Q_EMIT initialized();
+            return;
+        }
+        m_available = true;
+        for (auto it = appearance.cbegin(); it != appearance.cend(); ++it) {
+            handleSettingChanged(kAppearanceNamespace, it.key(), unwrapVariant(it.value()));
+        }
+        DEBUG << "Desktop portal color scheme:" << m_colorScheme.value_or(ColorScheme::NoPreference)
+              << "accent color:" << m_accentColor.value_or(QColor{});
+        Q_EMIT initialized();
+    });
+#else // !FRAMELESSHELPER_HAS_DBUS
+    m_initialized = true;
+    DEBUG << "FramelessHelper is built without D-Bus support, the desktop portal is not available.";
+#endif // FRAMELESSHELPER_HAS_DBUS
+}
+
+FRAMELESSHELPER_END_NAMESPACE
+
+#include "desktopportalsettings.moc"
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/desktopportalsettings_p.h"
@@ -0,0 +1,615 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "desktopwallpaperwatcher_p.h"
+#include "desktopportalsettings_p.h"
+#include "framelesshelper_linux.h"
+#include "utils.h"
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qurl.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qxmlstream.h>
+#include <QtCore/qtextstream.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qcoreapplication.h>
+#include <optional>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcDesktopWallpaperWatcher, "wangwenx190.framelesshelper.core.desktopwallpaperwatcher")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcDesktopWallpaperWatcher)
+#  define DEBUG qCDebug(lcDesktopWallpaperWatcher)
+#  define WARNING qCWarning(lcDesktopWallpaperWatcher)
+#  define CRITICAL qCCritical(lcDesktopWallpaperWatcher)
+#endif
+
+using namespace Global;
+
+FRAMELESSHELPER_STRING_CONSTANT(KDE)
+FRAMELESSHELPER_STRING_CONSTANT(XFCE)
+FRAMELESSHELPER_STRING_CONSTANT2(GnomeDconfFile, "dconf/user")
+FRAMELESSHELPER_STRING_CONSTANT2(GnomeKeyFile, "glib-2.0/settings/keyfile")
+FRAMELESSHELPER_STRING_CONSTANT2(GnomeKeyFileGroup, "[org/gnome/desktop/background]")
+FRAMELESSHELPER_STRING_CONSTANT2(KdeConfigFile, "plasma-org.kde.plasma.desktop-appletsrc")
+FRAMELESSHELPER_STRING_CONSTANT2(KdeWallpaperGroupSuffix, "[Wallpaper][org.kde.image][General]")
+FRAMELESSHELPER_STRING_CONSTANT2(KdePackageImagesDir, "contents/images")
+FRAMELESSHELPER_STRING_CONSTANT2(XfceConfigFile, "xfce4/xfconf/xfce-perchannel-xml/xfce4-desktop.xml")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureUri, "picture-uri")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureUriDark, "picture-uri-dark")
+FRAMELESSHELPER_STRING_CONSTANT2(PictureOptions, "picture-options")
+FRAMELESSHELPER_STRING_CONSTANT(Image)
+FRAMELESSHELPER_STRING_CONSTANT(FillMode)
+FRAMELESSHELPER_STRING_CONSTANT(property)
+FRAMELESSHELPER_STRING_CONSTANT(name)
+FRAMELESSHELPER_STRING_CONSTANT(value)
+FRAMELESSHELPER_STRING_CONSTANT2(LastImage, "last-image")
+FRAMELESSHELPER_STRING_CONSTANT2(ImageStyle, "image-style")
+
+[[maybe_unused]] static constexpr const char kGnomeBackgroundSchema[] = "org.gnome.desktop.background";
+
+// Configuration tools usually write their files several times in a row,
+// coalesce these notifications into a single refresh.
+static constexpr const int kRefreshDelay = 200; // ms
+
+struct WallpaperInfo
+{
+    QString filePath = {};
+    std::optional<WallpaperAspectStyle> aspectStyle = std::nullopt;
+};
+
+[[nodiscard]] static inline QString configFilePath(const QString &relativePath)
+{
+    static const QString configDir = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation);
+    return QDir(configDir).absoluteFilePath(relativePath);
+}
+
+[[nodiscard]] static inline QString toLocalFilePath(QString uri)
+{
+    // GVariant text format: strings are quoted.
+    if ((uri.size() >= 2) && uri.startsWith(u'\'') && uri.endsWith(u'\'')) {
+        uri = uri.mid(1, uri.size() - 2);
+    }
+    if (uri.isEmpty()) {
+        return {};
+    }
+    const QUrl url(uri);
+    return (url.isLocalFile() ? url.toLocalFile() : uri);
+}
+
+[[nodiscard]] static inline std::optional<WallpaperAspectStyle> gnomeAspectStyle(QString options)
+{
+    if ((options.size() >= 2) && options.startsWith(u'\'') && options.endsWith(u'\'')) {
+        options = options.mid(1, options.size() - 2);
+    }
+    if ((options == u"wallpaper") || (options == u"tiled")) {
+        return WallpaperAspectStyle::Tile;
+    } else if (options == u"centered") {
+        return WallpaperAspectStyle::Center;
+    } else if (options == u"stretched") {
+        return WallpaperAspectStyle::Stretch;
+    } else if (options == u"scaled") {
+        return WallpaperAspectStyle::Fit;
+    } else if (options == u"spanned") {
+        return WallpaperAspectStyle::Span;
+    } else if (options == u"zoom") {
+        return WallpaperAspectStyle::Fill;
+    }
+    return std::nullopt;
+}
+
+[[nodiscard]] static inline QString gsettingsString(const char *schemaId, const QString &key)
+{
+    Q_ASSERT(schemaId);
+    Q_ASSERT(!key.isEmpty());
+    if (!schemaId || key.isEmpty()) {
+        return {};
+    }
+    // GSettings aborts the whole process for unknown schemas and keys,
+    // so we have to check their existence first.
+    GSettingsSchemaSource * const source = g_settings_schema_source_get_default();
+    if (!source) {
+        return {};
+    }
+    GSettingsSchema * const schema = g_settings_schema_source_lookup(source, schemaId, true);
+    if (!schema) {
+        return {};
+    }
+    const QByteArray rawKey = key.toUtf8();
+    const bool hasKey = g_settings_schema_has_key(schema, rawKey.constData());
+    g_settings_schema_unref(schema);
+    if (!hasKey) {
+        return {};
+    }
+    GSettings * const settings = g_settings_new(schemaId);
+    if (!settings) {
+        return {};
+    }
+    gchar * const raw = g_settings_get_string(settings, rawKey.constData());
+    const QString result = QUtf8String(raw);
+    g_free(raw);
+    g_object_unref(reinterpret_cast<GObject *>(settings));
+    return result;
+}
+
+[[nodiscard]] static inline WallpaperInfo readGnomeWallpaper()
+{
+    // Light until the desktop portal has answered, so GTK is never loaded just for
+    // this, the watcher reads the wallpaper again when the answer arrives.
+    const bool dark = Utils::shouldAppsUseDarkMode();
+    WallpaperInfo info = {};
+    if (qEnvironmentVariable("GSETTINGS_BACKEND") == u"keyfile") {
+        QFile file(configFilePath(kGnomeKeyFile));
+        if (!file.open(QFile::ReadOnly | QFile::Text)) {
+            return {};
+        }
+        QTextStream stream(&file);
+        bool inGroup = false;
+        QString uri = {};
+        QString darkUri = {};
+        while (!stream.atEnd()) {
+            const QString line = stream.readLine().trimmed();
+            if (line.startsWith(u'[')) {
+                inGroup = (line == kGnomeKeyFileGroup);
+                continue;
+            }
+            if (!inGroup) {
+                continue;
+            }
+            const qsizetype separator = line.indexOf(u'=');
+            if (separator <= 0) {
+                continue;
+            }
+            const QString key = line.left(separator).trimmed();
+            const QString value = line.mid(separator + 1).trimmed();
+            if (key == kPictureUri) {
+                uri = value;
+            } else if (key == kPictureUriDark) {
+                darkUri = value;
+            } else if (key == kPictureOptions) {
+                info.aspectStyle = gnomeAspectStyle(value);
+            }
+        }
+        info.filePath = toLocalFilePath((dark && !darkUri.isEmpty()) ? darkUri : uri);
+        return info;
+    }
+    const QString darkUri = (dark ? gsettingsString(kGnomeBackgroundSchema, kPictureUriDark) : QString{});
+    info.filePath = toLocalFilePath(darkUri.isEmpty() ? gsettingsString(kGnomeBackgroundSchema, kPictureUri) : darkUri);
+    info.aspectStyle = gnomeAspectStyle(gsettingsString(kGnomeBackgroundSchema, kPictureOptions));
+    return info;
+}
+
+[[nodiscard]] static inline QString kdePackageImage(const QString &packagePath)
+{
+    // Wallpaper packages ship the same image in several resolutions,
+    // their file names are the resolutions, pick the largest one.
+    const QDir dir(QDir(packagePath).absoluteFilePath(kKdePackageImagesDir));
+    const QFileInfoList images = dir.entryInfoList(QDir::Files, QDir::Name);
+    QString result = {};
+    qint64 largestArea = -1;
+    for (auto &&image : std::as_const(images)) {
+        const QStringList size = image.completeBaseName().split(u'x');
+        const qint64 area = ((size.size() == 2) ? (size.at(0).toLongLong() * size.at(1).toLongLong()) : 0);
+        if (area > largestArea) {
+            largestArea = area;
+            result = image.absoluteFilePath();
+        }
+    }
+    return result;
+}
+
+[[nodiscard]] static inline WallpaperInfo readKdeWallpaper()
+{
+    QFile file(configFilePath(kKdeConfigFile));
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        return {};
+    }
+    QTextStream stream(&file);
+    bool inGroup = false;
+    WallpaperInfo info = {};
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.startsWith(u'[')) {
+            // Only use the first containment which has a wallpaper image.
+            if (inGroup && !info.filePath.isEmpty()) {
+                break;
+            }
+            inGroup = line.endsWith(kKdeWallpaperGroupSuffix);
+            info.aspectStyle = std::nullopt;
+            continue;
+        }
+        if (!inGroup) {
+            continue;
+        }
+        const qsizetype separator = line.indexOf(u'=');
+        if (separator <= 0) {
+            continue;
+        }
+        const QString key = line.left(separator).trimmed();
+        const QString value = line.mid(separator + 1).trimmed();
+        if (key == kImage) {
+            info.filePath = toLocalFilePath(value);
+        } else if (key == kFillMode) {
+            switch (value.toInt()) {
+            case 0: // Stretch
+                info.aspectStyle = WallpaperAspectStyle::Stretch;
+                break;
+            case 1: // PreserveAspectFit
+                info.aspectStyle = WallpaperAspectStyle::Fit;
+                break;
+            case 2: // PreserveAspectCrop
+                info.aspectStyle = WallpaperAspectStyle::Fill;
+                break;
+            case 3: // Tile
+            case 4: // TileVertically
+            case 5: // TileHorizontally
+                info.aspectStyle = WallpaperAspectStyle::Tile;
+                break;
+            case 6: // Pad
+                info.aspectStyle = WallpaperAspectStyle::Center;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    if (QFileInfo(info.filePath).isDir()) {
+        info.filePath = kdePackageImage(info.filePath);
+    }
+    return info;
+}
+
+[[nodiscard]] static inline WallpaperInfo readXfceWallpaper()
+{
+    QFile file(configFilePath(kXfceConfigFile));
+    if (!file.open(QFile::ReadOnly)) {
+        return {};
+    }
+    // The settings are stored per monitor and per workspace, such as
+    // "/backdrop/screen0/monitor0/workspace0/last-image", only use the first one.
+    QXmlStreamReader reader(&file);
+    QStringList path = {};
+    QString imageParent = {};
+    WallpaperInfo info = {};
+    QHash<QString, WallpaperAspectStyle> styles = {};
+    while (!reader.atEnd()) {
+        const QXmlStreamReader::TokenType token = reader.readNext();
+        if ((token == QXmlStreamReader::EndElement) && (reader.name() == kproperty)) {
+            if (!path.isEmpty()) {
+                path.removeLast();
+            }
+            continue;
+        }
+        if ((token != QXmlStreamReader::StartElement) || (reader.name() != kproperty)) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = reader.attributes();
+        const QString name = attributes.value(kname).toString();
+        const QString parent = path.join(u'/');
+        path.append(name);
+        if ((name == kLastImage) && info.filePath.isEmpty()) {
+            info.filePath = attributes.value(kvalue).toString();
+            imageParent = parent;
+        } else if (name == kImageStyle) {
+            static constexpr const WallpaperAspectStyle kStyles[] = {
+                WallpaperAspectStyle::Center, // None
+                WallpaperAspectStyle::Center, // Centered
+                WallpaperAspectStyle::Tile, // Tiled
+                WallpaperAspectStyle::Stretch, // Stretched
+                WallpaperAspectStyle::Fit, // Scaled
+                WallpaperAspectStyle::Fill, // Zoomed
+                WallpaperAspectStyle::Span // Spanning screens
+            };
+            const int style = attributes.value(kvalue).toInt();
+            if ((style >= 0) && (style < int(std::size(kStyles)))) {
+                styles.insert(parent, kStyles[style]);
+            }
+        }
+    }
+    if (reader.hasError()) {
+        WARNING << "Failed to parse the XFCE desktop settings:" << reader.errorString();
+    }
+    if (!info.filePath.isEmpty()) {
+        const auto it = styles.constFind(imageParent);
+        if (it != styles.constEnd()) {
+            info.aspectStyle = it.value();
+        }
+    }
+    return info;
+}
+
+// Reads the whole image, never call it on the GUI thread.
+[[nodiscard]] static inline QByteArray wallpaperContentHash(const QString &filePath)
+{
+    if (filePath.isEmpty()) {
+        return {};
+    }
+    QFile file(filePath);
+    if (!file.open(QFile::ReadOnly)) {
+        return {};
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) {
+        return {};
+    }
+    return hash.result();
+}
+
+DesktopWallpaperWatcher::DesktopWallpaperWatcher(QObject *parent) : QObject(parent)
+{
+    // It's created by whoever asks for the wallpaper first, which may be a worker
+    // thread, but the file system watches and the timer belong to the GUI thread.
+    const QCoreApplication * const app = QCoreApplication::instance();
+    if (app && (thread() != app->thread())) {
+        moveToThread(app->thread());
+        QMetaObject::invokeMethod(this, [this](){ initialize(); }, Qt::QueuedConnection);
+        return;
+    }
+    initialize();
+}
+
+DesktopWallpaperWatcher::~DesktopWallpaperWatcher()
+{
+    // Never destroy a running thread.
+    if (m_hashThread) {
+        m_hashThread->wait();
+    }
+}
+
+DesktopWallpaperWatcher *DesktopWallpaperWatcher::instance()
+{
+    static DesktopWallpaperWatcher watcher;
+    return &watcher;
+}
+
+DesktopWallpaperWatcher::Desktop DesktopWallpaperWatcher::desktop() const
+{
+    return m_desktop;
+}
+
+QString DesktopWallpaperWatcher::wallpaper() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_wallpaper;
+}
+
+WallpaperAspectStyle DesktopWallpaperWatcher::aspectStyle() const
+{
+    const QMutexLocker locker(&m_mutex);
+    return m_aspectStyle;
+}
+
+void DesktopWallpaperWatcher::refresh()
+{
+    WallpaperInfo info = {};
+    switch (m_desktop) {
+    case Desktop::GNOME:
+        info = readGnomeWallpaper();
+        break;
+    case Desktop::KDE:
+        info = readKdeWallpaper();
+        break;
+    case Desktop::XFCE:
+        info = readXfceWallpaper();
+        break;
+    case Desktop::Unknown:
+        break;
+    }
+    const WallpaperAspectStyle aspectStyle = info.aspectStyle.value_or(WallpaperAspectStyle::Fill);
+    // The configuration files change for many unrelated reasons, and the image may be
+    // replaced in place, so only the actual content tells us if a rebuild is needed.
+    // Hashing a large image isn't cheap though, only do it (in the background) when
+    // the file itself looks different or has reported a change.
+    const QFileInfo imageInfo(info.filePath);
+    const qint64 imageSize = (info.filePath.isEmpty() ? -1 : imageInfo.size());
+    const QDateTime imageLastModified = (info.filePath.isEmpty() ? QDateTime() : imageInfo.lastModified());
+    bool changed = false;
+    bool needsHash = false;
+    {
+        const QMutexLocker locker(&m_mutex);
+        if (m_wallpaper != info.filePath) {
+            m_wallpaper = info.filePath;
+            // The hash of the new image is only the base line for the later comparisons.
+            m_contentHash.clear();
+            needsHash = !info.filePath.isEmpty();
+            changed = true;
+        } else if (m_imageFileChanged || (m_imageSize != imageSize) || (m_imageLastModified != imageLastModified)) {
+            needsHash = !info.filePath.isEmpty();
+        }
+        if (m_aspectStyle != aspectStyle) {
+            m_aspectStyle = aspectStyle;
+            changed = true;
+        }
+        m_imageSize = imageSize;
+        m_imageLastModified = imageLastModified;
+        m_imageFileChanged = false;
+    }
+    updateWatchedPaths();
+    if (needsHash) {
+        scheduleContentHash();
+    }
+    if (!changed) {
+        return;
+    }
+    DEBUG << "Wallpaper changed:" << info.filePath << aspectStyle;
+    Q_EMIT wallpaperChanged();
+}
+
+void DesktopWallpaperWatcher::scheduleContentHash()
+{
+    if (m_hashRunning) {
+        // Hash again once the current one is done, it may be outdated already.
+        m_hashPending = true;
+        return;
+    }
+    if (m_hashThread) {
+        // It has already posted us its result, there's almost nothing left to wait for.
+        m_hashThread->wait();
+    }
+    m_hashRunning = true;
+    const QString filePath = wallpaper();
+    m_hashThread.reset(QThread::create([this, filePath](){
+        const QByteArray hash = wallpaperContentHash(filePath);
+        QMetaObject::invokeMethod(this, [this, filePath, hash](){
+            handleContentHash(filePath, hash);
+        }, Qt::QueuedConnection);
+    }));
+    m_hashThread->setObjectName(FRAMELESSHELPER_STRING_LITERAL("WallpaperHashThread"));
+    m_hashThread->start(QThread::LowPriority);
+}
+
+void DesktopWallpaperWatcher::handleContentHash(const QString &filePath, const QByteArray &hash)
+{
+    m_hashRunning = false;
+    bool changed = false;
+    {
+        const QMutexLocker locker(&m_mutex);
+        // Outdated if the wallpaper changed meanwhile, a new hash has been requested for it then.
+        if ((filePath == m_wallpaper) && !hash.isEmpty()) {
+            if (m_contentHash.isEmpty()) {
+                m_contentHash = hash;
+            } else if (m_contentHash != hash) {
+                m_contentHash = hash;
+                changed = true;
+            }
+        }
+    }
+    if (m_hashPending) {
+        m_hashPending = false;
+        scheduleContentHash();
+    }
+    if (!changed) {
+        return;
+    }
+    DEBUG << "Wallpaper content changed:" << filePath;
+    Q_EMIT wallpaperChanged();
+}
+
+void DesktopWallpaperWatcher::updateWatchedPaths()
+{
+    // Many programs save files by writing a temporary file and renaming it to the
+    // target path, which removes the original file from the watch list, so we
+    // also watch the parent directories and re-add the files when necessary.
+    QStringList files = m_configFiles;
+    if (const QString image = wallpaper(); !image.isEmpty()) {
+        files.append(image);
+    }
+    QStringList directories = {};
+    for (auto &&file : std::as_const(files)) {
+        directories.append(QFileInfo(file).absolutePath());
+    }
+    const QStringList watchedFiles = m_watcher.files();
+    const QStringList watchedDirectories = m_watcher.directories();
+    QStringList obsolete = {};
+    for (auto &&file : std::as_const(watchedFiles)) {
+        if (!files.contains(file)) {
+            obsolete.append(file);
+        }
+    }
+    for (auto &&directory : std::as_const(watchedDirectories)) {
+        if (!directories.contains(directory)) {
+            obsolete.append(directory);
+        }
+    }
+    if (!obsolete.isEmpty()) {
+        std::ignore = m_watcher.removePaths(obsolete);
+    }
+    const QStringList paths = (files + directories);
+    QStringList missing = {};
+    for (auto &&path : std::as_const(paths)) {
+        if (!watchedFiles.contains(path) && !watchedDirectories.contains(path)
+            && !missing.contains(path) && QFileInfo::exists(path)) {
+            missing.append(path);
+        }
+    }
+    if (!missing.isEmpty()) {
+        std::ignore = m_watcher.addPaths(missing);
+    }
+}
+
+void DesktopWallpaperWatcher::initialize()
+{
+    const QStringList currentDesktops = qEnvironmentVariable("XDG_CURRENT_DESKTOP").split(u':');
+    const auto isDesktop = [&currentDesktops](const QString &name) -> bool {
+        return currentDesktops.contains(name, Qt::CaseInsensitive);
+    };
+    if (isDesktop(kKDE)) {
+        m_desktop = Desktop::KDE;
+        m_configFiles.append(configFilePath(kKdeConfigFile));
+    } else if (isDesktop(kXFCE)) {
+        m_desktop = Desktop::XFCE;
+        m_configFiles.append(configFilePath(kXfceConfigFile));
+    } else {
+        // GNOME and most of its derivatives.
+        m_desktop = Desktop::GNOME;
+        m_configFiles.append(configFilePath(kGnomeDconfFile));
+        m_configFiles.append(configFilePath(kGnomeKeyFile));
+        // GNOME has a separate wallpaper for the dark theme, which is only known
+        // for sure once the desktop portal has answered.
+        DesktopPortalSettings * const portalSettings = DesktopPortalSettings::instance();
+        connect(portalSettings, &DesktopPortalSettings::initialized, this, [this](){
+            m_refreshTimer.start();
+        });
+        connect(portalSettings, &DesktopPortalSettings::colorSchemeChanged, this, [this](){
+            m_refreshTimer.start();
+        });
+    }
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(kRefreshDelay);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &DesktopWallpaperWatcher::refresh);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &file){
+        if (file == wallpaper()) {
+            m_imageFileChanged = true;
+        }
+        m_refreshTimer.start();
+    });
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &directory){
+        // Only care about the files we are interested in, not the whole directory.
+        const QStringList watchedFiles = m_watcher.files();
+        QStringList files = m_configFiles;
+        files.append(wallpaper());
+        for (auto &&file : std::as_const(files)) {
+            if (!file.isEmpty() && (QFileInfo(file).absolutePath() == directory)
+                && (watchedFiles.contains(file) != QFileInfo::exists(file))) {
+                m_refreshTimer.start();
+                return;
+            }
+        }
+    });
+    refresh();
+    DEBUG << "Current desktop:" << m_desktop << "wallpaper:" << m_wallpaper << m_aspectStyle;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
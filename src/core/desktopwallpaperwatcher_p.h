@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/desktopwallpaperwatcher_p.h"
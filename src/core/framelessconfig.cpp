@@ -23,8 +23,10 @@
  */
 
 #include "framelessconfig_p.h"
+#include "cachebudget_p.h"
 #include <array>
 #include <memory>
+#include <optional>
 #include <QtCore/qdir.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qcoreapplication.h>
@@ -66,11 +68,14 @@ static constexpr const std::array<FramelessConfigEntry, static_cast<int>(Option:
     FramelessConfigEntry{ "FRAMELESSHELPER_ENABLE_BLUR_BEHIND_WINDOW", "Options/EnableBlurBehindWindow" },
     FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NON_NATIVE_BACKGROUND_BLUR", "Options/ForceNonNativeBackgroundBlur" },
     FramelessConfigEntry{ "FRAMELESSHELPER_DISABLE_LAZY_INITIALIZATION_FOR_MICA_MATERIAL", "Options/DisableLazyInitializationForMicaMaterial" },
-    FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NATIVE_BACKGROUND_BLUR", "Options/ForceNativeBackgroundBlur" }
+    FramelessConfigEntry{ "FRAMELESSHELPER_FORCE_NATIVE_BACKGROUND_BLUR", "Options/ForceNativeBackgroundBlur" },
+    FramelessConfigEntry{ "FRAMELESSHELPER_WINDOW_USE_CLIENT_SIDE_SHADOW", "Options/WindowUseClientSideShadow" }
 };
 
 static constexpr const auto OptionCount = std::size(FramelessOptionsTable);
 
+static constexpr const FramelessConfigEntry CacheMemoryBudgetEntry = { "FRAMELESSHELPER_CACHE_MEMORY_BUDGET", "Options/CacheMemoryBudget" };
+
 struct FramelessConfigData
 {
     bool loaded = false;
@@ -81,6 +86,33 @@ struct FramelessConfigData
 
 Q_GLOBAL_STATIC(FramelessConfigData, g_framelessConfigData)
 
+// Accepts a plain number of bytes, or one with a "K", "M" or "G" suffix (binary units).
+[[nodiscard]] static inline std::optional<qint64> parseMemorySize(const QString &text)
+{
+    QString value = text.trimmed().toUpper();
+    if (value.endsWith(u'B')) {
+        value.chop(1);
+    }
+    qint64 multiplier = 1;
+    if (value.endsWith(u'K')) {
+        multiplier = (qint64(1) << 10);
+    } else if (value.endsWith(u'M')) {
+        multiplier = (qint64(1) << 20);
+    } else if (value.endsWith(u'G')) {
+        multiplier = (qint64(1) << 30);
+    }
+    if (multiplier != 1) {
+        value.chop(1);
+    }
+    bool ok = false;
+    const qint64 number = value.trimmed().toLongLong(&ok);
+    if (!ok || (number < 0)) {
+        WARNING << "Invalid memory size:" << text;
+        return std::nullopt;
+    }
+    return (number * multiplier);
+}
+
 static inline void warnInappropriateOptions()
 {
     const FramelessConfig * const cfg = FramelessConfig::instance();
@@ -104,9 +136,14 @@ static inline void warnInappropriateOptions()
     if (cfg->isSet(Option::ForceNonNativeBackgroundBlur) && cfg->isSet(Option::ForceNativeBackgroundBlur)) {
         WARNING << "Option::ForceNonNativeBackgroundBlur and Option::ForceNativeBackgroundBlur can't be both enabled.";
     }
-    if (cfg->isSet(Option::WindowUseRoundCorners)) {
-        WARNING << "Option::WindowUseRoundCorners has not been implemented yet.";
+#ifdef Q_OS_WINDOWS
+    if (cfg->isSet(Option::WindowUseRoundCorners) && !cfg->isSet(Option::UseCrossPlatformQtImplementation)) {
+        WARNING << "Option::WindowUseRoundCorners is only available for the cross-platform Qt implementation.";
     }
+    if (cfg->isSet(Option::WindowUseClientSideShadow) && !cfg->isSet(Option::UseCrossPlatformQtImplementation)) {
+        WARNING << "Option::WindowUseClientSideShadow is only available for the cross-platform Qt implementation.";
+    }
+#endif // Q_OS_WINDOWS
 }
 
 FramelessConfig::FramelessConfig(QObject *parent) : QObject(parent)
@@ -142,6 +179,19 @@ void FramelessConfig::reload(const bool force)
             && configFile->value(QUtf8String(FramelessOptionsTable.at(i).cfg), false).toBool());
         g_framelessConfigData()->options.at(i) = (envVar || cfgFile);
     }
+    const std::optional<qint64> budget = [&configFile]() -> std::optional<qint64> {
+        if (!g_framelessConfigData()->disableEnvVar && qEnvironmentVariableIsSet(CacheMemoryBudgetEntry.env)) {
+            return parseMemorySize(qEnvironmentVariable(CacheMemoryBudgetEntry.env));
+        }
+        if (!g_framelessConfigData()->disableCfgFile && configFile) {
+            const QString key = QUtf8String(CacheMemoryBudgetEntry.cfg);
+            if (configFile->contains(key)) {
+                return parseMemorySize(configFile->value(key).toString());
+            }
+        }
+        return std::nullopt;
+    }();
+    CacheBudget::instance()->setBudget(budget.value_or(0));
     g_framelessConfigData()->loaded = true;
 
     QTimer::singleShot(0, this, [](){ warnInappropriateOptions(); });
@@ -157,6 +207,16 @@ bool FramelessConfig::isSet(const Option option) const
     return g_framelessConfigData()->options.at(static_cast<int>(option));
 }
 
+qint64 FramelessConfig::cacheMemoryBudget() const
+{
+    return CacheBudget::instance()->budget();
+}
+
+void FramelessConfig::setCacheMemoryBudget(const qint64 bytes)
+{
+    CacheBudget::instance()->setBudget(bytes);
+}
+
 void FramelessConfig::setLoadFromEnvironmentVariablesDisabled(const bool on)
 {
     g_framelessConfigData()->disableEnvVar = on;
@@ -28,6 +28,11 @@
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
 #include "utils.h"
+#include "tracing_p.h"
+#include "statistics_p.h"
+#include "windowcornermask_p.h"
+#include "framethrottle_p.h"
+#include "windowshadowpainter.h"
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
@@ -56,12 +61,42 @@ struct FramelessQtHelperData
     FramelessHelperQt *eventFilter = nullptr;
     bool cursorShapeChanged = false;
     bool leftButtonPressed = false;
+    FrameThrottle *windowShapeThrottle = nullptr;
+    WindowShadowPainter *shadowPainter = nullptr;
 };
 
 using FramelessQtHelperInternal = QHash<WId, FramelessQtHelperData>;
 
 Q_GLOBAL_STATIC(FramelessQtHelperInternal, g_framelessQtHelperData)
 
+static inline void updateWindowShape(QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return;
+    }
+    FRAMELESSHELPER_TRACE_SCOPE("corners", "updateWindowShape");
+    QRegion region = {};
+    const Qt::WindowState state = window->windowState();
+    if ((state != Qt::WindowMaximized) && (state != Qt::WindowFullScreen)) {
+        region = WindowCornerMask::windowRegion(window->size(), kDefaultWindowCornerRadius, window->devicePixelRatio());
+    }
+    // Every new mask is a round trip to the window system, don't send the same one again.
+    if (window->mask() == region) {
+        return;
+    }
+    window->setMask(region);
+}
+
+static inline void scheduleWindowShapeUpdate(const FramelessQtHelperData &data)
+{
+    // Interactive resizing sends us far more resize events than the screen can show, apply
+    // the first one within a frame and fold all the others which arrive meanwhile into it.
+    if (data.windowShapeThrottle) {
+        data.windowShapeThrottle->schedule();
+    }
+}
+
 FramelessHelperQt::FramelessHelperQt(QObject *parent) : QObject(parent) {}
 
 FramelessHelperQt::~FramelessHelperQt() = default;
@@ -82,7 +117,21 @@ void FramelessHelperQt::addWindow(FramelessParamsConst params)
     QWindow *window = params->getWindowHandle();
     // Give it a parent so that it can be automatically deleted by Qt.
     data.eventFilter = new FramelessHelperQt(window);
+    const bool roundCorners = FramelessConfig::instance()->isSet(Option::WindowUseRoundCorners);
+    if (FramelessConfig::instance()->isSet(Option::WindowUseClientSideShadow)) {
+        // Only the margins are handled here, painting it is up to whoever draws the window.
+        data.shadowPainter = new WindowShadowPainter(data.eventFilter);
+        if (roundCorners) {
+            data.shadowPainter->setCornerRadius(kDefaultWindowCornerRadius);
+        }
+        data.shadowPainter->setWindow(window);
+    } else if (roundCorners) {
+        // The window shape would cut the shadow off, so translucent windows which have one
+        // have to clear their corners themselves.
+        data.windowShapeThrottle = new FrameThrottle(window, [window](){ updateWindowShape(window); }, data.eventFilter);
+    }
     g_framelessQtHelperData()->insert(windowId, data);
+    StatisticsRecorder::add(StatisticsRecorder::Counter::QtWindow);
     const auto shouldApplyFramelessFlag = []() -> bool {
 #ifdef Q_OS_MACOS
         return false;
@@ -105,6 +154,10 @@ void FramelessHelperQt::addWindow(FramelessParamsConst params)
 #endif // Q_OS_LINUX
     }
     window->installEventFilter(data.eventFilter);
+    scheduleWindowShapeUpdate(data);
+    // Note: there's no need to handle _NET_WM_SYNC_REQUEST here, Qt's XCB plugin already
+    // advertises it whenever the window manager supports it, and it updates the counter
+    // itself after each backing store flush, OpenGL buffer swap or Vulkan present.
     FramelessHelper::Core::setApplicationOSThemeAware();
 }
 
@@ -118,12 +171,35 @@ void FramelessHelperQt::removeWindow(const WId windowId)
     if (it == g_framelessQtHelperData()->constEnd()) {
         return;
     }
+    if (FrameThrottle * const throttle = it.value().windowShapeThrottle) {
+        throttle->cancel();
+        throttle->deleteLater();
+    }
+    if (WindowShadowPainter * const shadow = it.value().shadowPainter) {
+        shadow->setWindow(nullptr);
+        shadow->deleteLater();
+    }
     g_framelessQtHelperData()->erase(it);
+    StatisticsRecorder::add(StatisticsRecorder::Counter::QtWindow, -1);
 #ifdef Q_OS_MACOS
     Utils::removeWindowProxy(windowId);
 #endif
 }
 
+WindowShadowPainter *FramelessHelperQt::windowShadowPainter(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return nullptr;
+    }
+    for (auto &&data : std::as_const(*g_framelessQtHelperData())) {
+        if (data.shadowPainter && (data.shadowPainter->window() == window)) {
+            return data.shadowPainter;
+        }
+    }
+    return nullptr;
+}
+
 bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
 {
     Q_ASSERT(object);
@@ -149,6 +225,14 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
         return QObject::eventFilter(object, event);
     }
     const QEvent::Type type = event->type();
+    if ((type == QEvent::Resize) || (type == QEvent::WindowStateChange)) {
+        const auto window = qobject_cast<QWindow *>(object);
+        const auto it = g_framelessQtHelperData()->constFind(window->winId());
+        if (it != g_framelessQtHelperData()->constEnd()) {
+            scheduleWindowShapeUpdate(it.value());
+        }
+        return QObject::eventFilter(object, event);
+    }
     // We are only interested in some specific mouse events (plus DPR change event).
     if ((type != QEvent::MouseButtonPress) && (type != QEvent::MouseButtonRelease)
             && (type != QEvent::MouseButtonDblClick) && (type != QEvent::MouseMove)
@@ -160,6 +244,7 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
             ) {
         return QObject::eventFilter(object, event);
     }
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessHelperQt::eventFilter");
     const auto window = qobject_cast<QWindow *>(object);
     const WId windowId = window->winId();
     const auto it = g_framelessQtHelperData()->find(windowId);
@@ -174,6 +259,7 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
     if (type == QEvent::ScreenChangeInternal)
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 6, 0))
     {
+        scheduleWindowShapeUpdate(data);
         data.params.forceChildrenRepaint(500);
         return QObject::eventFilter(object, event);
     }
@@ -233,10 +319,12 @@ bool FramelessHelperQt::eventFilter(QObject *object, QEvent *event)
             const Qt::CursorShape cs = Utils::calculateCursorShape(window, scenePos);
             if (cs == Qt::ArrowCursor) {
                 if (data.cursorShapeChanged) {
+                    StatisticsRecorder::add(StatisticsRecorder::Counter::CursorUpdate);
                     data.params.unsetCursor();
                     muData.cursorShapeChanged = false;
                 }
             } else {
+                StatisticsRecorder::add(StatisticsRecorder::Counter::CursorUpdate);
                 data.params.setCursor(cs);
                 muData.cursorShapeChanged = true;
             }
@@ -30,6 +30,7 @@
 #include "winverhelper_p.h"
 #include "framelesshelper_windows.h"
 #include "framelesshelpercore_global_p.h"
+#include "statistics_p.h"
 #include <optional>
 #include <memory>
 #include <QtCore/qhash.h>
@@ -557,6 +558,7 @@ void FramelessHelperWin::addWindow(FramelessParamsConst params)
     data.params = *params;
     data.dpi = {Utils::getWindowDpi(windowId, true), Utils::getWindowDpi(windowId, false)};
     g_framelessWin32HelperData()->data.insert(windowId, data);
+    StatisticsRecorder::add(StatisticsRecorder::Counter::Win32Window);
     if (!g_framelessWin32HelperData()->nativeEventFilter) {
         g_framelessWin32HelperData()->nativeEventFilter = std::make_unique<FramelessHelperWin>();
         qApp->installNativeEventFilter(g_framelessWin32HelperData()->nativeEventFilter.get());
@@ -626,6 +628,7 @@ void FramelessHelperWin::removeWindow(const WId windowId)
         return;
     }
     g_framelessWin32HelperData()->data.erase(it);
+    StatisticsRecorder::add(StatisticsRecorder::Counter::Win32Window, -1);
     if (g_framelessWin32HelperData()->data.isEmpty()) {
         if (g_framelessWin32HelperData()->nativeEventFilter) {
             qApp->removeNativeEventFilter(g_framelessWin32HelperData()->nativeEventFilter.get());
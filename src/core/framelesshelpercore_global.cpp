@@ -26,6 +26,7 @@
 #include "framelesshelpercore_global_p.h"
 #include "versionnumber_p.h"
 #include "utils.h"
+#include "sysapiloader_p.h"
 #include <QtCore/qiodevice.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qloggingcategory.h>
@@ -125,6 +126,10 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+#ifdef Q_OS_LINUX
+extern SysApiLoader::PreloadManifest sysApiPreloadManifest();
+#endif // Q_OS_LINUX
+
 #ifdef Q_OS_WINDOWS
 static_assert(std::size(WindowsVersions) == (static_cast<int>(WindowsVersion::Latest) + 1));
 #endif
@@ -164,6 +169,9 @@ void initialize()
     // Fedora and Arch users report segfault when calling XInitThreads() and gtk_init().
     //XInitThreads(); // Users report that GTK is crashing without this.
     //gtk_init(nullptr, nullptr); // Users report that GTK functionalities won't work without this.
+    // Resolve the XCB symbols we use in the background, so that the first
+    // window drag doesn't have to wait for the dynamic linker.
+    SysApiLoader::preload(sysApiPreloadManifest());
 #endif
 
 #if (defined(Q_OS_MACOS) && (QT_VERSION < QT_VERSION_CHECK(6, 0, 0)))
@@ -206,6 +214,8 @@ void uninitialize()
         return;
     }
     uninited = true;
+
+    SysApiLoader::waitForPreload();
 }
 
 VersionInfo version()
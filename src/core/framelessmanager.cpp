@@ -28,14 +28,27 @@
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
 #include "utils.h"
+#include "tracing_p.h"
+#include "statistics_p.h"
+#include "cachebudget_p.h"
 #ifdef Q_OS_WINDOWS
 #  include "framelesshelper_win.h"
 #  include "winverhelper_p.h"
 #endif
+#ifdef Q_OS_LINUX
+#  include "desktopportalsettings_p.h"
+#  include "desktopwallpaperwatcher_p.h"
+#endif
+#include <QtCore/qhash.h>
 #include <QtCore/qvariant.h>
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qmetaobject.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qfontdatabase.h>
+#include <QtGui/qfontmetrics.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpixmap.h>
 #include <QtGui/qwindow.h>
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 5, 0))
 #  include <QtGui/qguiapplication.h>
@@ -64,7 +77,45 @@ using FramelessManagerData = QList<WId>;
 
 Q_GLOBAL_STATIC(FramelessManagerData, g_framelessManagerData)
 
+// Glyph -> (color, point size, device pixel ratio) -> rasterized glyph.
+using GlyphCacheData = QHash<QString, QHash<quint64, QPixmap>>;
+
+Q_GLOBAL_STATIC(GlyphCacheData, g_glyphCacheData)
+
 static constexpr const int kEventDelayInterval = 1000;
+static constexpr const int kStatisticsUpdateInterval = 1000;
+
+// There are only a handful of system button glyphs, colors and scale factors in
+// practice, this limit only exists to protect us from unbounded growth.
+static constexpr const int kMaximumGlyphCacheSize = 256;
+
+[[nodiscard]] static inline qint64 glyphCacheBytes()
+{
+    qint64 bytes = 0;
+    for (auto &&glyphs : std::as_const(*g_glyphCacheData())) {
+        for (auto &&pixmap : std::as_const(glyphs)) {
+            bytes += (qint64(pixmap.width()) * qint64(pixmap.height()) * qint64(pixmap.depth()) / 8);
+        }
+    }
+    return bytes;
+}
+
+static inline void trimGlyphCache(const qint64 bytes)
+{
+    Q_UNUSED(bytes);
+    if (g_glyphCacheData()->isEmpty()) {
+        return;
+    }
+    // The system buttons rasterize their glyphs again the next time they are painted.
+    g_glyphCacheData()->clear();
+    CacheBudget::instance()->setUsage(CacheBudget::Cache::Glyphs, 0);
+}
+
+[[nodiscard]] static inline quint64 glyphCacheKey(const QColor &color, const int pointSize, const qreal devicePixelRatio)
+{
+    const auto dpr = quint64(std::round(devicePixelRatio * qreal(100)));
+    return ((quint64(color.rgba()) << 32) | ((quint64(pointSize) & 0xffff) << 16) | (dpr & 0xffff));
+}
 
 #ifndef FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
 [[nodiscard]] static inline QString iconFontFamilyName()
@@ -124,11 +175,14 @@ void FramelessManagerPrivate::initializeIconFont()
     inited = true;
     framelesshelpercore_initResource();
     // We always register this font because it's our only fallback.
-    const int id = QFontDatabase::addApplicationFont(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/fonts/iconfont.ttf"));
+    static const auto fontPath = FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/fonts/iconfont.ttf");
+    const int id = QFontDatabase::addApplicationFont(fontPath);
     if (id < 0) {
         WARNING << "Failed to load icon font.";
     } else {
         DEBUG << "Successfully registered icon font.";
+        // The font database keeps a copy of the whole file in memory.
+        CacheBudget::instance()->setUsage(CacheBudget::Cache::IconFont, QFileInfo(fontPath).size());
     }
 #endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
 }
@@ -152,6 +206,53 @@ QFont FramelessManagerPrivate::getIconFont()
 #endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
 }
 
+QPixmap FramelessManagerPrivate::getGlyphPixmap(const QString &glyph, const QColor &color,
+                                                const int pointSize, const qreal devicePixelRatio)
+{
+    Q_ASSERT(!glyph.isEmpty());
+    Q_ASSERT(color.isValid());
+    Q_ASSERT(pointSize > 0);
+    Q_ASSERT(devicePixelRatio > 0);
+    if (glyph.isEmpty() || !color.isValid() || (pointSize <= 0) || (devicePixelRatio <= 0)) {
+        return {};
+    }
+    // Shaping and rasterizing the icon font glyph is a lot more expensive than blitting
+    // a pixmap, and the system buttons get repainted on every hover/press transition,
+    // so we rasterize each combination once and share the result between all buttons
+    // of all windows.
+    const quint64 key = glyphCacheKey(color, pointSize, devicePixelRatio);
+    QHash<quint64, QPixmap> &glyphs = (*g_glyphCacheData())[glyph];
+    const auto it = glyphs.constFind(key);
+    if (it != glyphs.constEnd()) {
+        return it.value();
+    }
+    if (glyphs.size() >= kMaximumGlyphCacheSize) {
+        glyphs.clear();
+        CacheBudget::instance()->setUsage(CacheBudget::Cache::Glyphs, glyphCacheBytes());
+    }
+    QFont font = getIconFont();
+    font.setPointSize(pointSize);
+    const QFontMetrics fontMetrics(font);
+    const QSize size = {Utils::horizontalAdvance(fontMetrics, glyph), fontMetrics.height()};
+    if (size.isEmpty()) {
+        return {};
+    }
+    QPixmap pixmap(QSizeF(QSizeF(size) * devicePixelRatio).toSize());
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(kDefaultTransparentColor);
+    {
+        QPainter painter(&pixmap);
+        painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+        painter.setPen(color);
+        painter.setFont(font);
+        painter.drawText(QRect(QPoint(0, 0), size), Qt::AlignCenter, glyph);
+    }
+    glyphs.insert(key, pixmap);
+    CacheBudget::instance()->addUsage(CacheBudget::Cache::Glyphs,
+        (qint64(pixmap.width()) * qint64(pixmap.height()) * qint64(pixmap.depth()) / 8));
+    return pixmap;
+}
+
 SystemTheme FramelessManagerPrivate::systemTheme() const
 {
     // The user's choice has top priority.
@@ -168,12 +269,39 @@ QColor FramelessManagerPrivate::systemAccentColor() const
 
 QString FramelessManagerPrivate::wallpaper() const
 {
+#ifdef Q_OS_LINUX
+    // Starts watching the wallpaper if nobody has asked for it before.
+    return Utils::getWallpaperFilePath();
+#else // !Q_OS_LINUX
     return m_wallpaper;
+#endif // Q_OS_LINUX
 }
 
 WallpaperAspectStyle FramelessManagerPrivate::wallpaperAspectStyle() const
 {
+#ifdef Q_OS_LINUX
+    return Utils::getWallpaperAspectStyle();
+#else // !Q_OS_LINUX
     return m_wallpaperAspectStyle;
+#endif // Q_OS_LINUX
+}
+
+void FramelessManagerPrivate::ensureWallpaperWatcher()
+{
+#ifdef Q_OS_LINUX
+    // The watcher needs file system watches, a hashing thread and GSettings, most
+    // applications never use the wallpaper, so it's only created for the first
+    // consumer (a mica material or anybody asking for the wallpaper path).
+    [[maybe_unused]] static const bool connected = []() -> bool {
+        FramelessManager * const manager = FramelessManager::instance();
+        // The watcher only notifies us when the image content really changed, even if
+        // the file path is still the same, so always forward its notifications.
+        connect(DesktopWallpaperWatcher::instance(), &DesktopWallpaperWatcher::wallpaperChanged, manager, [manager](){
+            get(manager)->doNotifyWallpaperHasChangedOrNot(true);
+        });
+        return true;
+    }();
+#endif // Q_OS_LINUX
 }
 
 void FramelessManagerPrivate::addWindow(FramelessParamsConst params)
@@ -233,8 +361,23 @@ void FramelessManagerPrivate::notifyWallpaperHasChangedOrNot()
     m_wallpaperTimer.start();
 }
 
+void FramelessManagerPrivate::updateStatisticsTimer()
+{
+    Q_Q(FramelessManager);
+    // Don't wake up the application for nothing if nobody is listening.
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&FramelessManager::statisticsUpdated))) {
+        if (!m_statisticsTimer.isActive()) {
+            m_statisticsTimer.start();
+        }
+    } else {
+        m_statisticsTimer.stop();
+    }
+}
+
 void FramelessManagerPrivate::doNotifySystemThemeHasChangedOrNot()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("theme", "doNotifySystemThemeHasChangedOrNot");
+    StatisticsRecorder::add(StatisticsRecorder::Counter::ThemeQuery);
     const SystemTheme currentSystemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
     const QColor currentAccentColor = Utils::getAccentColor();
 #ifdef Q_OS_WINDOWS
@@ -268,11 +411,12 @@ void FramelessManagerPrivate::doNotifySystemThemeHasChangedOrNot()
     }
 }
 
-void FramelessManagerPrivate::doNotifyWallpaperHasChangedOrNot()
+void FramelessManagerPrivate::doNotifyWallpaperHasChangedOrNot(const bool force)
 {
+    FRAMELESSHELPER_TRACE_SCOPE("theme", "doNotifyWallpaperHasChangedOrNot");
     const QString currentWallpaper = Utils::getWallpaperFilePath();
     const WallpaperAspectStyle currentWallpaperAspectStyle = Utils::getWallpaperAspectStyle();
-    bool notify = false;
+    bool notify = force;
     if (m_wallpaper != currentWallpaper) {
         m_wallpaper = currentWallpaper;
         notify = true;
@@ -333,13 +477,22 @@ void FramelessManagerPrivate::initialize()
         m_wallpaperTimer.stop();
         doNotifyWallpaperHasChangedOrNot();
     });
+    CacheBudget::instance()->setTrimmer(CacheBudget::Cache::Glyphs, trimGlyphCache);
+    m_statisticsTimer.setInterval(kStatisticsUpdateInterval);
+    m_statisticsTimer.callOnTimeout(this, [this](){
+        Q_Q(FramelessManager);
+        Q_EMIT q->statisticsUpdated();
+    });
     m_systemTheme = (Utils::shouldAppsUseDarkMode() ? SystemTheme::Dark : SystemTheme::Light);
     m_accentColor = Utils::getAccentColor();
 #ifdef Q_OS_WINDOWS
     m_colorizationArea = Utils::getDwmColorizationArea();
 #endif
+#ifndef Q_OS_LINUX
+    // Reading the wallpaper on Linux is deferred until somebody needs it.
     m_wallpaper = Utils::getWallpaperFilePath();
     m_wallpaperAspectStyle = Utils::getWallpaperAspectStyle();
+#endif // Q_OS_LINUX
     DEBUG.nospace() << "Current system theme: " << m_systemTheme
                     << ", accent color: " << m_accentColor.name(QColor::HexArgb).toUpper()
 #ifdef Q_OS_WINDOWS
@@ -361,6 +514,22 @@ void FramelessManagerPrivate::initialize()
         });
     }
 #endif // ((QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)) && !defined(Q_OS_WINDOWS))
+#ifdef Q_OS_LINUX
+    // The desktop portal tells us exactly when the appearance settings change,
+    // so there's no need to wait for other notifications to settle down. Its
+    // first answer arrives asynchronously, the light theme is assumed until
+    // then, and without a portal the GTK settings are only read after that.
+    DesktopPortalSettings * const portalSettings = DesktopPortalSettings::instance();
+    connect(portalSettings, &DesktopPortalSettings::initialized, this, [this](){
+        doNotifySystemThemeHasChangedOrNot();
+    });
+    connect(portalSettings, &DesktopPortalSettings::colorSchemeChanged, this, [this](){
+        doNotifySystemThemeHasChangedOrNot();
+    });
+    connect(portalSettings, &DesktopPortalSettings::accentColorChanged, this, [this](){
+        doNotifySystemThemeHasChangedOrNot();
+    });
+#endif // Q_OS_LINUX
     static bool flagSet = false;
     if (!flagSet) {
         flagSet = true;
@@ -410,6 +579,16 @@ WallpaperAspectStyle FramelessManager::wallpaperAspectStyle() const
     return d->wallpaperAspectStyle();
 }
 
+RuntimeStatistics FramelessManager::statistics() const
+{
+    return StatisticsRecorder::snapshot();
+}
+
+CacheMemoryUsage FramelessManager::cacheMemoryUsage() const
+{
+    return CacheBudget::instance()->snapshot();
+}
+
 void FramelessManager::addWindow(FramelessParamsConst params)
 {
     Q_D(FramelessManager);
@@ -428,4 +607,24 @@ void FramelessManager::setOverrideTheme(const SystemTheme theme)
     d->setOverrideTheme(theme);
 }
 
+void FramelessManager::connectNotify(const QMetaMethod &signal)
+{
+    QObject::connectNotify(signal);
+    if (signal == QMetaMethod::fromSignal(&FramelessManager::statisticsUpdated)) {
+        // Connections can be made from any thread, but the timer lives in ours.
+        Q_D(FramelessManager);
+        QMetaObject::invokeMethod(d, "updateStatisticsTimer", Qt::QueuedConnection);
+    }
+}
+
+void FramelessManager::disconnectNotify(const QMetaMethod &signal)
+{
+    QObject::disconnectNotify(signal);
+    // An invalid method means a wildcard disconnect.
+    if (!signal.isValid() || (signal == QMetaMethod::fromSignal(&FramelessManager::statisticsUpdated))) {
+        Q_D(FramelessManager);
+        QMetaObject::invokeMethod(d, "updateStatisticsTimer", Qt::QueuedConnection);
+    }
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "framethrottle_p.h"
+#include <QtGui/qscreen.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+static constexpr const qreal kDefaultRefreshRate = 60;
+
+FrameThrottle::FrameThrottle(QWindow *window, const Callback &callback, QObject *parent)
+    : QObject(parent), m_window(window), m_callback(callback)
+{
+    Q_ASSERT(window);
+    Q_ASSERT(callback);
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, [this](){
+        if (m_window && m_callback) {
+            m_callback();
+        }
+    });
+}
+
+FrameThrottle::~FrameThrottle() = default;
+
+int FrameThrottle::frameInterval(const QWindow *window)
+{
+    Q_ASSERT(window);
+    const QScreen * const screen = (window ? window->screen() : nullptr);
+    const qreal refreshRate = (screen ? screen->refreshRate() : qreal(0));
+    return qMax(1, qRound(qreal(1000) / ((refreshRate > qreal(1)) ? refreshRate : kDefaultRefreshRate)));
+}
+
+void FrameThrottle::schedule()
+{
+    if (!m_window || m_timer.isActive()) {
+        return;
+    }
+    // The screen (and thus its refresh rate) may have changed since the last time.
+    m_timer.setInterval(frameInterval(m_window));
+    m_timer.start();
+}
+
+void FrameThrottle::cancel()
+{
+    m_timer.stop();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
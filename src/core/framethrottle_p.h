@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/framethrottle_p.h"
@@ -24,22 +24,34 @@
 
 #include "micamaterial.h"
 #include "micamaterial_p.h"
+#include "wallpapersource.h"
 #include "framelessmanager.h"
+#include "framelessmanager_p.h"
 #include "utils.h"
 #include "framelessconfig_p.h"
 #include "framelesshelpercore_global_p.h"
+#include "tracing_p.h"
+#include "statistics_p.h"
+#include "cachebudget_p.h"
 #include <optional>
 #include <memory>
+#include <algorithm>
+#include <limits>
 #include <QtCore/qsysinfo.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
 #include <QtGui/qpixmap.h>
 #include <QtGui/qimage.h>
 #include <QtGui/qimagereader.h>
 #include <QtGui/qpainter.h>
 #include <QtGui/qscreen.h>
 #include <QtGui/qguiapplication.h>
+#include <QtGui/qwindow.h>
 #ifndef FRAMELESSHELPER_CORE_NO_PRIVATE
 #  include <QtGui/private/qmemrotate_p.h>
 #endif // FRAMELESSHELPER_CORE_NO_PRIVATE
@@ -73,6 +85,9 @@ using namespace Global;
 [[maybe_unused]] static constexpr const qreal kDefaultTintOpacity = 0.7;
 [[maybe_unused]] static constexpr const qreal kDefaultNoiseOpacity = 0.04;
 [[maybe_unused]] static constexpr const qreal kDefaultBlurRadius = 128.0;
+[[maybe_unused]] static constexpr const quint32 kNoiseSeed = 0x9E3779B9U;
+// The wallpaper is heavily blurred anyway, a quarter of the resolution still looks almost the same.
+[[maybe_unused]] static constexpr const int kMaximumWallpaperReduction = 4;
 
 [[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultSystemLightColor2 = {243, 243, 243}; // #F3F3F3
 
@@ -81,20 +96,68 @@ using namespace Global;
 
 struct ImageData
 {
-    QPixmap blurredWallpaper = {};
-    bool graphicsResourcesReady = false;
+    // Blurred wallpapers of the screens that host (or have hosted) mica windows,
+    // keyed by the logical size of the screen. Screens of the same size share
+    // the same wallpaper.
+    QHash<quint64, BlurredWallpaper> cache = {};
+    QList<QSize> pendingSizes = {};
+    quint64 generation = 0;
+    bool workerRunning = false;
     QMutex mutex{};
 };
 
-struct MetricsData
+struct WallpaperSourceData
 {
-    std::optional<QSize> monitorSize = std::nullopt;
-    std::optional<QSize> wallpaperSize = std::nullopt;
+    QPointer<WallpaperSource> source = nullptr;
+    QMetaObject::Connection connection = {};
+    // How many threads are calling into each source right now, without holding the lock.
+    QHash<WallpaperSource *, int> users = {};
+    QWaitCondition usersChanged{};
     QMutex mutex{};
 };
 
 Q_GLOBAL_STATIC(ImageData, g_imageData)
-Q_GLOBAL_STATIC(MetricsData, g_metricsData)
+Q_GLOBAL_STATIC(WallpaperSourceData, g_wallpaperSourceData)
+
+[[nodiscard]] static inline quint64 wallpaperCacheKey(const QSize &monitorSize)
+{
+    return ((quint64(quint32(monitorSize.width())) << 32) | quint64(quint32(monitorSize.height())));
+}
+
+[[nodiscard]] static inline qint64 pixmapBytes(const QPixmap &pixmap)
+{
+    return (qint64(pixmap.width()) * qint64(pixmap.height()) * qint64(pixmap.depth()) / 8);
+}
+
+static inline void reportWallpaperCacheUsage()
+{
+    qint64 bytes = 0;
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        for (auto &&wallpaper : std::as_const(g_imageData()->cache)) {
+            bytes += pixmapBytes(wallpaper.pixmap);
+        }
+    }
+    CacheBudget::instance()->setUsage(CacheBudget::Cache::Wallpapers, bytes);
+}
+
+// Picks the largest resolution that still fits into the cache budget, taking into
+// account that the wallpaper currently cached for this screen size will be replaced.
+[[nodiscard]] static inline int wallpaperReduction(const QSize &monitorSize, const qint64 replacedBytes)
+{
+    const qint64 available = CacheBudget::instance()->available();
+    if (available == std::numeric_limits<qint64>::max()) {
+        return 1;
+    }
+    const QSize size = MicaMaterialPrivate::wallpaperSize(monitorSize);
+    const qint64 fullBytes = (qint64(size.width()) * qint64(size.height()) * 4);
+    const qint64 room = (available + replacedBytes);
+    int reduction = 1;
+    while ((reduction < kMaximumWallpaperReduction) && ((fullBytes / (reduction * reduction)) > room)) {
+        reduction *= 2;
+    }
+    return reduction;
+}
 
 #ifndef FRAMELESSHELPER_CORE_NO_PRIVATE
 template<const int shift>
@@ -415,7 +478,9 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
         // We need a blurry image anyway, we don't need high quality image processing.
         p->setRenderHint(QPainter::Antialiasing, false);
         p->setRenderHint(QPainter::TextAntialiasing, false);
-        p->setRenderHint(QPainter::SmoothPixmapTransform, false);
+        // Like Qt's own qt_blurImage(): a nearest neighbor upscale turns the smooth
+        // blur into 2x2 blocks, which shows up as steps on large gradients.
+        p->setRenderHint(QPainter::SmoothPixmapTransform, (scale > 1.0));
         p->scale(scale, scale);
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 2, 0))
         const QSize imageSize = blurImage.deviceIndependentSize().toSize();
@@ -490,6 +555,137 @@ static inline void expblur(QImage &img, qreal radius, const bool improvedQuality
     return {x, y, w, h};
 }
 
+[[nodiscard]] static inline QImage loadWallpaperImage(WallpaperAspectStyle *aspectStyle)
+{
+    FRAMELESSHELPER_TRACE_SCOPE("mica", "loadWallpaperImage");
+    Q_ASSERT(aspectStyle);
+    if (!aspectStyle) {
+        return {};
+    }
+    WallpaperSource *source = nullptr;
+    {
+        // Keep the source registered as in use, so that unregistering it waits for us
+        // before the caller can destroy it. But don't hold the lock while calling into
+        // it, the user code may take long or even need MicaMaterial itself.
+        const QMutexLocker locker(&g_wallpaperSourceData()->mutex);
+        source = g_wallpaperSourceData()->source;
+        if (source) {
+            ++g_wallpaperSourceData()->users[source];
+        }
+    }
+    if (source) {
+        *aspectStyle = source->aspectStyle();
+        QImage image = source->image(kMaximumPictureSize);
+        {
+            const QMutexLocker locker(&g_wallpaperSourceData()->mutex);
+            auto &users = g_wallpaperSourceData()->users;
+            if (--users[source] <= 0) {
+                users.remove(source);
+            }
+            g_wallpaperSourceData()->usersChanged.wakeAll();
+        }
+        if (image.isNull()) {
+            WARNING << "The custom wallpaper source didn't provide any image.";
+            return {};
+        }
+        if ((image.width() > kMaximumPictureSize.width()) || (image.height() > kMaximumPictureSize.height())) {
+            image = image.scaled(kMaximumPictureSize, Qt::KeepAspectRatio, Qt::FastTransformation);
+        }
+        return image;
+    }
+    *aspectStyle = Utils::getWallpaperAspectStyle();
+    const QString wallpaperFilePath = Utils::getWallpaperFilePath();
+    if (wallpaperFilePath.isEmpty()) {
+        WARNING << "Failed to retrieve the wallpaper file path.";
+        return {};
+    }
+    // QImageReader allows us read the image size before we actually loading it, this behavior
+    // can help us avoid consume too much memory if the image resolution is very large, eg, 4K.
+    QImageReader reader(wallpaperFilePath);
+    if (!reader.canRead()) {
+        WARNING << "Qt can't read the wallpaper file:" << reader.errorString();
+        return {};
+    }
+    const QSize actualSize = reader.size();
+    if (actualSize.isEmpty()) {
+        WARNING << "The wallpaper picture size is invalid.";
+        return {};
+    }
+    const QSize correctedSize = (actualSize > kMaximumPictureSize ? kMaximumPictureSize : actualSize);
+    if (correctedSize != actualSize) {
+        DEBUG << "The wallpaper picture size is greater than 1920x1080, it will be shrinked to reduce memory consumption.";
+        reader.setScaledSize(correctedSize);
+    }
+    QImage image(correctedSize, kDefaultImageFormat);
+    if (!reader.read(&image)) {
+        WARNING << "Failed to read the wallpaper image:" << reader.errorString();
+        return {};
+    }
+    if (image.isNull()) {
+        WARNING << "The obtained image data is null.";
+        return {};
+    }
+    return image;
+}
+
+[[nodiscard]] static inline BlurredWallpaper blurWallpaper(const QImage &source,
+    const WallpaperAspectStyle aspectStyle, const QSize &monitorSize, const int reduction = 1)
+{
+    FRAMELESSHELPER_TRACE_SCOPE("mica", "blurWallpaper");
+    BlurredWallpaper result = {};
+    result.monitorSize = monitorSize;
+    result.reduction = reduction;
+    const QSize imageSize = (MicaMaterialPrivate::wallpaperSize(monitorSize) / reduction);
+    result.size = imageSize;
+    // If we scaled the image size, record the scale factor and we need it to map our clip rect
+    // to the real (unscaled) rect.
+    if (imageSize != monitorSize) {
+        result.transform.Horizontal = (qreal(imageSize.width()) / qreal(monitorSize.width()));
+        result.transform.Vertical = (qreal(imageSize.height()) / qreal(monitorSize.height()));
+    }
+    QImage image = source;
+    QImage buffer(imageSize, kDefaultImageFormat);
+#ifdef Q_OS_WINDOWS
+    if (aspectStyle == WallpaperAspectStyle::Center) {
+        buffer.fill(kDefaultBlackColor);
+    }
+#endif
+    if ((aspectStyle == WallpaperAspectStyle::Stretch)
+        || (aspectStyle == WallpaperAspectStyle::Fit)
+        || (aspectStyle == WallpaperAspectStyle::Fill)) {
+        Qt::AspectRatioMode mode = Qt::KeepAspectRatioByExpanding;
+        if (aspectStyle == WallpaperAspectStyle::Stretch) {
+            mode = Qt::IgnoreAspectRatio;
+        } else if (aspectStyle == WallpaperAspectStyle::Fit) {
+            mode = Qt::KeepAspectRatio;
+        }
+        QSize newSize = image.size();
+        newSize.scale(imageSize, mode);
+        image = image.scaled(newSize);
+    }
+    static constexpr const QPoint desktopOriginPoint = {0, 0};
+    const QRect desktopRect = {desktopOriginPoint, imageSize};
+    if (aspectStyle == WallpaperAspectStyle::Tile) {
+        QPainter bufferPainter(&buffer);
+        // Same as above, we prefer speed than quality here.
+        bufferPainter.setRenderHint(QPainter::Antialiasing, false);
+        bufferPainter.setRenderHint(QPainter::TextAntialiasing, false);
+        bufferPainter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        bufferPainter.fillRect(desktopRect, QBrush(image));
+    } else {
+        QPainter bufferPainter(&buffer);
+        // Same here.
+        bufferPainter.setRenderHint(QPainter::Antialiasing, false);
+        bufferPainter.setRenderHint(QPainter::TextAntialiasing, false);
+        bufferPainter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+        const QRect rect = alignedRect(Qt::LeftToRight, Qt::AlignCenter, image.size(), desktopRect);
+        bufferPainter.drawImage(rect.topLeft(), image);
+    }
+    // Keep the same amount of blur relative to the screen, no matter how much the image has been shrunk.
+    result.pixmap = QPixmap::fromImage(MicaMaterialPrivate::blurImage(buffer, (kDefaultBlurRadius / reduction)));
+    return result;
+}
+
 class WallpaperThread : public QThread
 {
     Q_OBJECT
@@ -500,105 +696,58 @@ public:
     ~WallpaperThread() override = default;
 
 Q_SIGNALS:
-    void imageUpdated(const Transform &);
+    void imageUpdated();
 
 protected:
     void run() override
     {
-        Transform transform = {};
-        const QSize monitorSize = MicaMaterialPrivate::monitorSize();
-        const QSize imageSize = MicaMaterialPrivate::wallpaperSize();
-        // If we scaled the image size, record the scale factor and we need it to map our clip rect
-        // to the real (unscaled) rect.
-        if (imageSize != monitorSize) {
-            transform.Horizontal = (qreal(imageSize.width()) / qreal(monitorSize.width()));
-            transform.Vertical = (qreal(imageSize.height()) / qreal(monitorSize.height()));
-        }
-        const QString wallpaperFilePath = Utils::getWallpaperFilePath();
-        if (wallpaperFilePath.isEmpty()) {
-            WARNING << "Failed to retrieve the wallpaper file path.";
-            return;
-        }
-        // QImageReader allows us read the image size before we actually loading it, this behavior
-        // can help us avoid consume too much memory if the image resolution is very large, eg, 4K.
-        QImageReader reader(wallpaperFilePath);
-        if (!reader.canRead()) {
-            WARNING << "Qt can't read the wallpaper file:" << reader.errorString();
-            return;
-        }
-        const QSize actualSize = reader.size();
-        if (actualSize.isEmpty()) {
-            WARNING << "The wallpaper picture size is invalid.";
-            return;
-        }
-        const QSize correctedSize = (actualSize > kMaximumPictureSize ? kMaximumPictureSize : actualSize);
-        if (correctedSize != actualSize) {
-            DEBUG << "The wallpaper picture size is greater than 1920x1080, it will be shrinked to reduce memory consumption.";
-            reader.setScaledSize(correctedSize);
-        }
-        QImage image(correctedSize, kDefaultImageFormat);
-        if (!reader.read(&image)) {
-            WARNING << "Failed to read the wallpaper image:" << reader.errorString();
-            return;
-        }
-        if (image.isNull()) {
-            WARNING << "The obtained image data is null.";
-            return;
-        }
-        WallpaperAspectStyle aspectStyle = Utils::getWallpaperAspectStyle();
-        QImage buffer(imageSize, kDefaultImageFormat);
-#ifdef Q_OS_WINDOWS
-        if (aspectStyle == WallpaperAspectStyle::Center) {
-            buffer.fill(kDefaultBlackColor);
-        }
-#endif
-        if ((aspectStyle == WallpaperAspectStyle::Stretch)
-            || (aspectStyle == WallpaperAspectStyle::Fit)
-            || (aspectStyle == WallpaperAspectStyle::Fill)) {
-            Qt::AspectRatioMode mode = Qt::KeepAspectRatioByExpanding;
-            if (aspectStyle == WallpaperAspectStyle::Stretch) {
-                mode = Qt::IgnoreAspectRatio;
-            } else if (aspectStyle == WallpaperAspectStyle::Fit) {
-                mode = Qt::KeepAspectRatio;
+        // The wallpaper is decoded only once per run and shared by all the queued screens,
+        // it's only reloaded if the wallpaper has changed in the mean time.
+        QImage image = {};
+        WallpaperAspectStyle aspectStyle = WallpaperAspectStyle::Fill;
+        std::optional<quint64> decodedGeneration = std::nullopt;
+        while (!isInterruptionRequested()) {
+            QSize monitorSize = {};
+            quint64 generation = 0;
+            qint64 replacedBytes = 0;
+            {
+                const QMutexLocker locker(&g_imageData()->mutex);
+                if (g_imageData()->pendingSizes.isEmpty()) {
+                    g_imageData()->workerRunning = false;
+                    return;
+                }
+                monitorSize = g_imageData()->pendingSizes.takeFirst();
+                generation = g_imageData()->generation;
+                replacedBytes = pixmapBytes(g_imageData()->cache.value(wallpaperCacheKey(monitorSize)).pixmap);
+            }
+            if (decodedGeneration != generation) {
+                image = loadWallpaperImage(&aspectStyle);
+                decodedGeneration = generation;
+            }
+            BlurredWallpaper wallpaper = {};
+            if (image.isNull()) {
+                // Remember the failure, otherwise every repaint would try again.
+                wallpaper.monitorSize = monitorSize;
+            } else {
+                wallpaper = blurWallpaper(image, aspectStyle, monitorSize, wallpaperReduction(monitorSize, replacedBytes));
+            }
+            wallpaper.generation = generation;
+            {
+                FRAMELESSHELPER_TRACE_SCOPE("mica", "publishWallpaper");
+                const QMutexLocker locker(&g_imageData()->mutex);
+                g_imageData()->cache.insert(wallpaperCacheKey(monitorSize), wallpaper);
+            }
+            reportWallpaperCacheUsage();
+            if (!image.isNull()) {
+                StatisticsRecorder::add(StatisticsRecorder::Counter::WallpaperRebuildCompleted);
+                Q_EMIT imageUpdated();
             }
-            QSize newSize = image.size();
-            newSize.scale(imageSize, mode);
-            image = image.scaled(newSize);
-        }
-        static constexpr const QPoint desktopOriginPoint = {0, 0};
-        const QRect desktopRect = {desktopOriginPoint, imageSize};
-        if (aspectStyle == WallpaperAspectStyle::Tile) {
-            QPainter bufferPainter(&buffer);
-            // Same as above, we prefer speed than quality here.
-            bufferPainter.setRenderHint(QPainter::Antialiasing, false);
-            bufferPainter.setRenderHint(QPainter::TextAntialiasing, false);
-            bufferPainter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-            bufferPainter.fillRect(desktopRect, QBrush(image));
-        } else {
-            QPainter bufferPainter(&buffer);
-            // Same here.
-            bufferPainter.setRenderHint(QPainter::Antialiasing, false);
-            bufferPainter.setRenderHint(QPainter::TextAntialiasing, false);
-            bufferPainter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-            const QRect rect = alignedRect(Qt::LeftToRight, Qt::AlignCenter, image.size(), desktopRect);
-            bufferPainter.drawImage(rect.topLeft(), image);
-        }
-        {
-            const QMutexLocker locker(&g_imageData()->mutex);
-            g_imageData()->blurredWallpaper = QPixmap(imageSize);
-            g_imageData()->blurredWallpaper.fill(kDefaultTransparentColor);
-            QPainter painter(&g_imageData()->blurredWallpaper);
-            // Same here.
-            painter.setRenderHint(QPainter::Antialiasing, false);
-            painter.setRenderHint(QPainter::TextAntialiasing, false);
-            painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-#ifdef FRAMELESSHELPER_CORE_NO_PRIVATE
-            painter.drawImage(desktopOriginPoint, buffer);
-#else // !FRAMELESSHELPER_CORE_NO_PRIVATE
-            qt_blurImage(&painter, buffer, kDefaultBlurRadius, false, false);
-#endif // FRAMELESSHELPER_CORE_NO_PRIVATE
         }
-        Q_EMIT imageUpdated(transform);
+        const QMutexLocker locker(&g_imageData()->mutex);
+        // We were interrupted, everything still in the queue will never be built.
+        StatisticsRecorder::add(StatisticsRecorder::Counter::WallpaperRebuildCancelled, g_imageData()->pendingSizes.size());
+        g_imageData()->pendingSizes.clear();
+        g_imageData()->workerRunning = false;
     }
 };
 
@@ -620,6 +769,220 @@ static inline void threadCleaner()
     }
 }
 
+static inline void startWallpaperThread()
+{
+    const QMutexLocker locker(&g_threadData()->mutex);
+    // No MicaMaterial has been created yet, the wallpaper will be generated on demand later.
+    if (!g_threadData()->thread) {
+        const QMutexLocker imageLocker(&g_imageData()->mutex);
+        g_imageData()->workerRunning = false;
+        return;
+    }
+    // The previous run has already drained the queue and is about to return,
+    // wait for it so that we can start it again.
+    g_threadData()->thread->wait();
+    g_threadData()->thread->start(QThread::LowPriority);
+}
+
+static inline void pruneBlurredWallpapers()
+{
+    QSet<quint64> keys = {};
+    const auto screens = QGuiApplication::screens();
+    for (auto &&screen : std::as_const(screens)) {
+        keys.insert(wallpaperCacheKey(MicaMaterialPrivate::monitorSize(screen)));
+    }
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        auto it = g_imageData()->cache.begin();
+        while (it != g_imageData()->cache.end()) {
+            if (keys.contains(it.key())) {
+                ++it;
+            } else {
+                it = g_imageData()->cache.erase(it);
+            }
+        }
+    }
+    reportWallpaperCacheUsage();
+}
+
+static inline void requestBlurredWallpaper(const QSize &monitorSize)
+{
+    bool unknownSize = false;
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        const auto it = g_imageData()->cache.constFind(wallpaperCacheKey(monitorSize));
+        if ((it != g_imageData()->cache.constEnd()) && (it.value().generation == g_imageData()->generation)) {
+            return;
+        }
+        if (g_imageData()->pendingSizes.contains(monitorSize)) {
+            StatisticsRecorder::add(StatisticsRecorder::Counter::WallpaperRebuildCoalesced);
+            return;
+        }
+        unknownSize = (it == g_imageData()->cache.constEnd());
+    }
+    // A screen we have never seen before usually means the screen configuration has changed,
+    // drop the wallpapers of the screens that no longer exist.
+    if (unknownSize) {
+        pruneBlurredWallpapers();
+    }
+    StatisticsRecorder::add(StatisticsRecorder::Counter::WallpaperRebuildRequested);
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        g_imageData()->pendingSizes.append(monitorSize);
+        if (g_imageData()->workerRunning) {
+            return;
+        }
+        g_imageData()->workerRunning = true;
+    }
+    startWallpaperThread();
+}
+
+static inline void invalidateBlurredWallpapers()
+{
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        ++g_imageData()->generation;
+    }
+    // Nothing is rebuilt here. The stale wallpapers are kept for painting, and only the
+    // materials which are currently visible will repaint and request their replacement.
+    // This way hidden or minimized windows don't wake us up for nothing.
+    const QMutexLocker locker(&g_threadData()->mutex);
+    if (g_threadData()->thread) {
+        Q_EMIT g_threadData()->thread->imageUpdated();
+    }
+}
+
+static inline void trimBlurredWallpapers(const qint64 bytes)
+{
+    Q_UNUSED(bytes);
+    // The wallpapers of the screens that are gone are the cheapest to give up.
+    pruneBlurredWallpapers();
+    if (CacheBudget::instance()->available() > 0) {
+        return;
+    }
+    // Then rebuild the others at a lower resolution, but only if that would make any
+    // difference, otherwise we'd keep rebuilding the same wallpapers over and over again.
+    QList<BlurredWallpaper> wallpapers = {};
+    {
+        const QMutexLocker locker(&g_imageData()->mutex);
+        wallpapers = g_imageData()->cache.values();
+    }
+    const bool shrinkable = std::any_of(wallpapers.cbegin(), wallpapers.cend(), [](const BlurredWallpaper &wallpaper){
+        return (!wallpaper.pixmap.isNull()
+            && (wallpaperReduction(wallpaper.monitorSize, pixmapBytes(wallpaper.pixmap)) > wallpaper.reduction));
+    });
+    if (shrinkable) {
+        invalidateBlurredWallpapers();
+    }
+}
+
+[[nodiscard]] static inline BlurredWallpaper blurredWallpaper(const QSize &monitorSize)
+{
+    requestBlurredWallpaper(monitorSize);
+    const QMutexLocker locker(&g_imageData()->mutex);
+    return g_imageData()->cache.value(wallpaperCacheKey(monitorSize));
+}
+
+[[nodiscard]] static inline constexpr quint32 noiseHash(quint32 value)
+{
+    // A well known 32-bit integer hash (lowbias32), cheap enough to be evaluated for every pixel.
+    value ^= (value >> 16);
+    value *= 0x7feb352dU;
+    value ^= (value >> 15);
+    value *= 0x846ca68bU;
+    value ^= (value >> 16);
+    return value;
+}
+
+[[nodiscard]] static inline QImage generateNoiseTexture(const QSize &size, const qreal devicePixelRatio)
+{
+    // Generate the noise at the exact device pixel size, so it stays crisp on high DPI screens.
+    QImage image(size * devicePixelRatio, kDefaultImageFormat);
+    image.setDevicePixelRatio(devicePixelRatio);
+    const int width = image.width();
+    const int height = image.height();
+    for (int y = 0; y != height; ++y) {
+        auto line = reinterpret_cast<quint32 *>(image.scanLine(y));
+        const quint32 row = (quint32(y) << 16) ^ kNoiseSeed;
+        // Keep this loop free of branches and function calls, the compiler can vectorize it then.
+        for (int x = 0; x != width; ++x) {
+            const quint32 hash = noiseHash(row ^ quint32(x));
+            // The sum of two uniform bytes has a triangular distribution, which looks much
+            // more like film grain than plain uniform noise. Map it to [26, 227] so that
+            // the average stays at 50% gray.
+            const quint32 sum = ((hash & 0xFF) + ((hash >> 8) & 0xFF));
+            const quint32 gray = (26 + ((sum * 101) >> 8));
+            line[x] = (0xFF000000U | (gray << 16) | (gray << 8) | gray);
+        }
+    }
+    return image;
+}
+
+[[nodiscard]] static inline QBrush createMaterialBrush(const MicaMaterialPrivate::MaterialBrushKey &key)
+{
+    static constexpr const QSize tileSize = { 64, 64 };
+    QImage micaTexture = QImage(tileSize * key.devicePixelRatio, kDefaultImageFormat);
+    micaTexture.setDevicePixelRatio(key.devicePixelRatio);
+    QColor fillColor = ((key.theme == SystemTheme::Dark) ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
+    fillColor.setAlphaF(0.9f);
+    micaTexture.fill(fillColor);
+    QPainter painter(&micaTexture);
+    // Same as above. We need speed, not quality.
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setRenderHint(QPainter::TextAntialiasing, false);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+    painter.setOpacity(key.tintOpacity);
+    const QRect rect = {QPoint(0, 0), tileSize};
+    painter.fillRect(rect, QColor::fromRgba(key.tintColor));
+    if (key.noiseOpacity > qreal(0)) {
+        painter.setOpacity(key.noiseOpacity);
+        painter.drawImage(rect.topLeft(), generateNoiseTexture(tileSize, key.devicePixelRatio));
+    }
+    painter.end();
+    return QBrush(micaTexture);
+}
+
+struct MaterialBrushData
+{
+    // The tiles are owned by the materials that use them, we only keep weak references
+    // here so that a tile goes away together with its last user.
+    QList<std::pair<MicaMaterialPrivate::MaterialBrushKey, std::weak_ptr<const QBrush>>> brushes = {};
+    QMutex mutex{};
+};
+
+Q_GLOBAL_STATIC(MaterialBrushData, g_materialBrushData)
+
+[[nodiscard]] static inline MicaMaterialPrivate::BrushPtr sharedMaterialBrush(const MicaMaterialPrivate::MaterialBrushKey &key)
+{
+    const QMutexLocker locker(&g_materialBrushData()->mutex);
+    auto &brushes = g_materialBrushData()->brushes;
+    auto it = brushes.begin();
+    while (it != brushes.end()) {
+        if (it->second.expired()) {
+            it = brushes.erase(it);
+            continue;
+        }
+        if (it->first == key) {
+            if (const MicaMaterialPrivate::BrushPtr brush = it->second.lock()) {
+                return brush;
+            }
+        }
+        ++it;
+    }
+    StatisticsRecorder::add(StatisticsRecorder::Counter::MicaBrushRegeneration);
+    const QBrush texture = createMaterialBrush(key);
+    const QImage image = texture.textureImage();
+    const qint64 bytes = (qint64(image.bytesPerLine()) * qint64(image.height()));
+    CacheBudget::instance()->addUsage(CacheBudget::Cache::MaterialBrushes, bytes);
+    // Account the memory for exactly as long as the last material holds on to the tile.
+    const MicaMaterialPrivate::BrushPtr brush(new QBrush(texture), [bytes](const QBrush *value){
+        CacheBudget::instance()->addUsage(CacheBudget::Cache::MaterialBrushes, -bytes);
+        delete value;
+    });
+    brushes.append(std::make_pair(key, std::weak_ptr<const QBrush>(brush)));
+    return brush;
+}
+
 MicaMaterialPrivate::MicaMaterialPrivate(MicaMaterial *q) : QObject(q)
 {
     Q_ASSERT(q);
@@ -652,105 +1015,173 @@ const MicaMaterialPrivate *MicaMaterialPrivate::get(const MicaMaterial *q)
 
 void MicaMaterialPrivate::maybeGenerateBlurredWallpaper(const bool force)
 {
-    g_imageData()->mutex.lock();
-    if (!g_imageData()->blurredWallpaper.isNull() && !force) {
-        g_imageData()->mutex.unlock();
+    if (force) {
+        invalidateBlurredWallpapers();
         return;
     }
-    g_imageData()->mutex.unlock();
-    const QMutexLocker locker(&g_threadData()->mutex);
-    if (g_threadData()->thread->isRunning()) {
-        g_threadData()->thread->requestInterruption();
-        g_threadData()->thread->quit();
-        g_threadData()->thread->wait();
-    }
-    g_threadData()->thread->start(QThread::LowPriority);
+    // Nothing has been painted yet, so we don't know which screens will host mica windows.
+    // The primary screen is the most likely one.
+    requestBlurredWallpaper(monitorSize(QGuiApplication::primaryScreen()));
+}
+
+void MicaMaterialPrivate::prepareBlurredWallpaper(const QScreen *screen)
+{
+    // This is only a cache lookup if the screen's wallpaper has been generated already.
+    requestBlurredWallpaper(monitorSize(screen ? screen : QGuiApplication::primaryScreen()));
 }
 
 void MicaMaterialPrivate::updateMaterialBrush()
 {
-#ifndef FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    framelesshelpercore_initResource();
-    static const QImage noiseTexture = QImage(FRAMELESSHELPER_STRING_LITERAL(":/org.wangwenx190.FramelessHelper/resources/images/noise.png"));
-#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    QImage micaTexture = QImage(QSize(64, 64), kDefaultImageFormat);
-    QColor fillColor = ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultSystemDarkColor : kDefaultSystemLightColor2);
-    fillColor.setAlphaF(0.9f);
-    micaTexture.fill(fillColor);
-    QPainter painter(&micaTexture);
-    // Same as above. We need speed, not quality.
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    painter.setRenderHint(QPainter::TextAntialiasing, false);
-    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
-    painter.setOpacity(tintOpacity);
-    const QRect rect = {QPoint(0, 0), micaTexture.size()};
-    painter.fillRect(rect, tintColor);
-    painter.setOpacity(noiseOpacity);
-#ifndef FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    painter.fillRect(rect, QBrush(noiseTexture));
-#endif // FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
-    micaBrush = QBrush(micaTexture);
-    if (initialized) {
-        Q_Q(MicaMaterial);
-        Q_EMIT q->shouldRedraw();
+    // Just drop our reference, the new tile will be looked up from the shared cache
+    // the next time we paint, once the device pixel ratio is known.
+    micaBrush = nullptr;
+    requestRedraw();
+}
+
+void MicaMaterialPrivate::requestRedraw()
+{
+    if (!initialized) {
+        return;
+    }
+    // Nobody can see us, remember it and redraw once we become visible again.
+    if (suspended) {
+        redrawPending = true;
+        return;
+    }
+    redrawPending = false;
+    Q_Q(MicaMaterial);
+    Q_EMIT q->shouldRedraw();
+}
+
+void MicaMaterialPrivate::setWindow(QWindow *value)
+{
+    if (window == value) {
+        return;
+    }
+    if (window) {
+        window->removeEventFilter(this);
+    }
+    if (windowVisibilityChangeConnection) {
+        disconnect(windowVisibilityChangeConnection);
+        windowVisibilityChangeConnection = {};
+    }
+    window = value;
+    if (window) {
+        window->installEventFilter(this);
+        windowVisibilityChangeConnection = connect(window, &QWindow::visibilityChanged,
+            this, &MicaMaterialPrivate::updateSuspended);
     }
+    updateSuspended();
+}
+
+bool MicaMaterialPrivate::isSuspended() const
+{
+    return suspended;
+}
+
+void MicaMaterialPrivate::updateSuspended()
+{
+    // Without a window we have no idea whether we are visible or not, assume we are.
+    const bool value = (window && (!window->isVisible()
+        || (window->visibility() == QWindow::Minimized) || !window->isExposed()));
+    if (suspended == value) {
+        return;
+    }
+    suspended = value;
+    if (!suspended && redrawPending) {
+        requestRedraw();
+    }
+}
+
+bool MicaMaterialPrivate::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event) {
+        return false;
+    }
+    // The window is not exposed anymore if it's fully occluded by other windows, on
+    // the platforms which support reporting that.
+    if ((event->type() == QEvent::Expose) && window && (object == window)) {
+        updateSuspended();
+    }
+    return QObject::eventFilter(object, event);
+}
+
+MicaMaterialPrivate::BrushPtr MicaMaterialPrivate::materialBrush(const qreal devicePixelRatio)
+{
+    MaterialBrushKey key = {};
+    key.theme = FramelessManager::instance()->systemTheme();
+    key.tintColor = tintColor.rgba();
+    key.tintOpacity = tintOpacity;
+    key.noiseOpacity = noiseOpacity;
+    key.devicePixelRatio = devicePixelRatio;
+    if (!micaBrush || (micaBrushKey != key)) {
+        micaBrush = sharedMaterialBrush(key);
+        micaBrushKey = key;
+    }
+    return micaBrush;
 }
 
 void MicaMaterialPrivate::paint(QPainter *painter, const QRect &rect, const bool active)
 {
+    FRAMELESSHELPER_TRACE_SCOPE("mica", "paint");
     Q_ASSERT(painter);
     if (!painter) {
         return;
     }
-    prepareGraphicsResources();
     static constexpr const QPoint originPoint = {0, 0};
-    const QRect wallpaperRect = { originPoint, wallpaperSize() };
-    const QRect mappedRect = mapToWallpaper(rect);
+    const QScreen * const screen = screenForRect(rect);
+    // Only the screens that actually host mica windows get their own blurred wallpaper,
+    // it's generated in the background the first time we paint on that screen.
+    const BlurredWallpaper wallpaper = blurredWallpaper(monitorSize(screen));
+    const bool hasWallpaper = !wallpaper.pixmap.isNull();
+    // The wallpaper covers exactly one screen, so the rectangle needs to be relative to it.
+    const QRect screenRect = (screen ? rect.translated(-screen->geometry().topLeft()) : rect);
+    const QRect wallpaperRect = { originPoint, wallpaper.size };
+    const QRect mappedRect = (hasWallpaper ? mapToWallpaper(screenRect, wallpaper) : QRect{ originPoint, rect.size() });
+    StatisticsRecorder::add(StatisticsRecorder::Counter::MicaPaint);
+    StatisticsRecorder::add(StatisticsRecorder::Counter::MicaPixelBlitted, (qint64(mappedRect.width()) * qint64(mappedRect.height())));
     painter->save();
     // Same as above. Speed is more important here.
     painter->setRenderHint(QPainter::Antialiasing, false);
     painter->setRenderHint(QPainter::TextAntialiasing, false);
     painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
-    if (active) {
+    if (active && hasWallpaper) {
         const QRect intersectedRect = wallpaperRect.intersected(mappedRect);
-        g_imageData()->mutex.lock();
-        painter->drawPixmap(originPoint, g_imageData()->blurredWallpaper, intersectedRect);
-        g_imageData()->mutex.unlock();
+        painter->drawPixmap(originPoint, wallpaper.pixmap, intersectedRect);
         if (intersectedRect != mappedRect) {
             static constexpr const auto xOffset = QPoint{ 1, 0 };
             if (mappedRect.y() + mappedRect.height() <= wallpaperRect.height()) {
                 const QRect outerRect = { intersectedRect.topRight() + xOffset, QSize{ mappedRect.width() - intersectedRect.width(), intersectedRect.height() } };
                 const QPoint outerRectOriginPoint = originPoint + QPoint{ intersectedRect.width(), 0 } + xOffset;
-                const QRect mappedOuterRect = mapToWallpaper(outerRect);
-                const QMutexLocker locker(&g_imageData()->mutex);
-                painter->drawPixmap(outerRectOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRect);
+                const QRect mappedOuterRect = mapToWallpaper(outerRect, wallpaper);
+                painter->drawPixmap(outerRectOriginPoint, wallpaper.pixmap, mappedOuterRect);
             } else {
                 static constexpr const auto yOffset = QPoint{ 0, 1 };
                 const QRect outerRectBottom = { intersectedRect.bottomLeft() + yOffset, QSize{ intersectedRect.width(), mappedRect.height() - intersectedRect.height() } };
                 const QPoint outerRectBottomOriginPoint = originPoint + QPoint{ 0, intersectedRect.height() } + yOffset;
-                const QRect mappedOuterRectBottom = mapToWallpaper(outerRectBottom);
-                g_imageData()->mutex.lock();
-                painter->drawPixmap(outerRectBottomOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectBottom);
-                g_imageData()->mutex.unlock();
+                const QRect mappedOuterRectBottom = mapToWallpaper(outerRectBottom, wallpaper);
+                painter->drawPixmap(outerRectBottomOriginPoint, wallpaper.pixmap, mappedOuterRectBottom);
                 if (mappedRect.x() + mappedRect.width() > wallpaperRect.width()) {
                     const QRect outerRectRight = { intersectedRect.topRight() + xOffset, QSize{ mappedRect.width() - intersectedRect.width(), intersectedRect.height() } };
                     const QPoint outerRectRightOriginPoint = originPoint + QPoint{ intersectedRect.width(), 0 } + xOffset;
-                    const QRect mappedOuterRectRight = mapToWallpaper(outerRectRight);
+                    const QRect mappedOuterRectRight = mapToWallpaper(outerRectRight, wallpaper);
                     const QRect outerRectCorner = { intersectedRect.bottomRight() + xOffset + yOffset, QSize{ outerRectRight.width(), outerRectBottom.height() } };
                     const QPoint outerRectCornerOriginPoint = originPoint + QPoint{ intersectedRect.width(), intersectedRect.height() } + xOffset + yOffset;
-                    const QRect mappedOuterRectCorner = mapToWallpaper(outerRectCorner);
-                    const QMutexLocker locker(&g_imageData()->mutex);
-                    painter->drawPixmap(outerRectRightOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectRight);
-                    painter->drawPixmap(outerRectCornerOriginPoint, g_imageData()->blurredWallpaper, mappedOuterRectCorner);
+                    const QRect mappedOuterRectCorner = mapToWallpaper(outerRectCorner, wallpaper);
+                    painter->drawPixmap(outerRectRightOriginPoint, wallpaper.pixmap, mappedOuterRectRight);
+                    painter->drawPixmap(outerRectCornerOriginPoint, wallpaper.pixmap, mappedOuterRectCorner);
                 }
             }
         }
     }
     painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
     painter->setOpacity(qreal(1));
-    painter->fillRect(QRect{originPoint, mappedRect.size()}, [this, active]() -> QBrush {
+    painter->fillRect(QRect{originPoint, mappedRect.size()}, [this, painter, active]() -> QBrush {
         if (!fallbackEnabled || active) {
-            return micaBrush;
+            const QPaintDevice * const device = painter->device();
+            return *materialBrush(device ? device->devicePixelRatioF() : qreal(1));
         }
         if (fallbackColor.isValid()) {
             return fallbackColor;
@@ -762,10 +1193,6 @@ void MicaMaterialPrivate::paint(QPainter *painter, const QRect &rect, const bool
 
 void MicaMaterialPrivate::forceRebuildWallpaper()
 {
-    g_metricsData()->mutex.lock();
-    g_metricsData()->monitorSize = std::nullopt;
-    g_metricsData()->wallpaperSize = std::nullopt;
-    g_metricsData()->mutex.unlock();
     maybeGenerateBlurredWallpaper(true);
 }
 
@@ -775,14 +1202,19 @@ void MicaMaterialPrivate::initialize()
     if (!g_threadData()->thread) {
         g_threadData()->thread = std::make_unique<WallpaperThread>();
         qAddPostRoutine(threadCleaner);
+        CacheBudget::instance()->setTrimmer(CacheBudget::Cache::Wallpapers, trimBlurredWallpapers);
+        connect(qGuiApp, &QGuiApplication::screenRemoved, g_threadData()->thread.get(), [](){
+            pruneBlurredWallpapers();
+        });
+        // Only once for all the materials, not once per material.
+        connect(FramelessManager::instance(), &FramelessManager::wallpaperChanged, g_threadData()->thread.get(), [](){
+            invalidateBlurredWallpapers();
+        });
+        // Start watching the wallpaper here on the GUI thread, before the wallpaper
+        // thread asks for it for the first time.
+        FramelessManagerPrivate::ensureWallpaperWatcher();
     }
-    connect(g_threadData()->thread.get(), &WallpaperThread::imageUpdated, this, [this](const Transform &t){
-        transform = t;
-        if (initialized) {
-            Q_Q(MicaMaterial);
-            Q_EMIT q->shouldRedraw();
-        }
-    });
+    connect(g_threadData()->thread.get(), &WallpaperThread::imageUpdated, this, &MicaMaterialPrivate::requestRedraw);
     g_threadData()->mutex.unlock();
 
     tintColor = kDefaultTransparentColor;
@@ -795,28 +1227,38 @@ void MicaMaterialPrivate::initialize()
 
     connect(FramelessManager::instance(), &FramelessManager::systemThemeChanged,
         this, &MicaMaterialPrivate::updateMaterialBrush);
-    connect(FramelessManager::instance(), &FramelessManager::wallpaperChanged,
-        this, &MicaMaterialPrivate::forceRebuildWallpaper);
-    connect(qGuiApp, &QGuiApplication::primaryScreenChanged,
-        this, &MicaMaterialPrivate::forceRebuildWallpaper);
 
     if (FramelessConfig::instance()->isSet(Option::DisableLazyInitializationForMicaMaterial)) {
-        prepareGraphicsResources();
+        maybeGenerateBlurredWallpaper();
     }
 
     initialized = true;
 }
 
-void MicaMaterialPrivate::prepareGraphicsResources()
+QImage MicaMaterialPrivate::blurImage(const QImage &image, const qreal radius)
 {
-    g_imageData()->mutex.lock();
-    if (g_imageData()->graphicsResourcesReady) {
-        g_imageData()->mutex.unlock();
-        return;
+    FRAMELESSHELPER_TRACE_SCOPE("mica", "blurImage");
+    const StatisticsTimer statisticsTimer(StatisticsRecorder::Histogram::BlurDuration);
+    if (image.isNull()) {
+        return {};
     }
-    g_imageData()->graphicsResourcesReady = true;
-    g_imageData()->mutex.unlock();
-    maybeGenerateBlurredWallpaper();
+    QImage result(image.size(), kDefaultImageFormat);
+    result.setDevicePixelRatio(image.devicePixelRatio());
+    result.fill(kDefaultTransparentColor);
+    QPainter painter(&result);
+    // We need a blurry image anyway, we don't need high quality image processing.
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setRenderHint(QPainter::TextAntialiasing, false);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, false);
+#ifdef FRAMELESSHELPER_CORE_NO_PRIVATE
+    Q_UNUSED(radius);
+    painter.drawImage(QPoint(0, 0), image);
+#else // !FRAMELESSHELPER_CORE_NO_PRIVATE
+    QImage buffer = image;
+    qt_blurImage(&painter, buffer, radius, false, false);
+#endif // FRAMELESSHELPER_CORE_NO_PRIVATE
+    painter.end();
+    return result;
 }
 
 QColor MicaMaterialPrivate::systemFallbackColor()
@@ -824,54 +1266,41 @@ QColor MicaMaterialPrivate::systemFallbackColor()
     return ((FramelessManager::instance()->systemTheme() == SystemTheme::Dark) ? kDefaultFallbackColorDark : kDefaultFallbackColorLight);
 }
 
-QSize MicaMaterialPrivate::monitorSize()
-{
-    g_metricsData()->mutex.lock();
-    if (!g_metricsData()->monitorSize.has_value()) {
-        g_metricsData()->mutex.unlock();
-        const QScreen * const monitor = QGuiApplication::primaryScreen();
-        Q_ASSERT(monitor);
-        // We do not use the virtual desktop size here, instead, we only calculate the primary
-        // monitor size to simplify the logic, otherwise we will need a lot more code to take
-        // every case into account.
-        QSize size = (monitor ? monitor->size() : kMaximumPictureSize);
-        if (Q_UNLIKELY(size.isEmpty())) {
-            WARNING << "Failed to retrieve the monitor size. Using default size (1920x1080) instead ...";
-            size = kMaximumPictureSize;
+QScreen *MicaMaterialPrivate::screenForRect(const QRect &rect)
+{
+    // Follow what most window managers do: a window belongs to the screen its center is on.
+    const QPoint center = rect.center();
+    const auto screens = QGuiApplication::screens();
+    for (auto &&screen : std::as_const(screens)) {
+        if (screen->geometry().contains(center)) {
+            return screen;
         }
-        g_metricsData()->mutex.lock();
-        g_metricsData()->monitorSize = size;
-        // Don't unlock the mutex here, we'll unlock it from outside.
-        DEBUG << "Primary monitor size:" << size * (monitor ? monitor->devicePixelRatio() : qreal(1));
     }
-    const QSize result = g_metricsData()->monitorSize.value();
-    g_metricsData()->mutex.unlock();
-    return result;
+    return QGuiApplication::primaryScreen();
 }
 
-QSize MicaMaterialPrivate::wallpaperSize()
+QSize MicaMaterialPrivate::monitorSize(const QScreen *screen)
 {
-    g_metricsData()->mutex.lock();
-    if (!g_metricsData()->wallpaperSize.has_value()) {
-        g_metricsData()->mutex.unlock();
-        const QSize desktopSize = monitorSize();
-        // It's observed that QImage consumes too much memory if the image resolution is very large.
-        const QSize size = (desktopSize > kMaximumPictureSize ? kMaximumPictureSize : desktopSize);
-        g_metricsData()->mutex.lock();
-        g_metricsData()->wallpaperSize = size;
-        // Don't unlock the mutex here, we'll unlock it from outside.
-        DEBUG << "Wallpaper size:" << size;
+    QSize size = (screen ? screen->size() : kMaximumPictureSize);
+    if (Q_UNLIKELY(size.isEmpty())) {
+        WARNING << "Failed to retrieve the monitor size. Using default size (1920x1080) instead ...";
+        size = kMaximumPictureSize;
     }
-    const QSize result = g_metricsData()->wallpaperSize.value();
-    g_metricsData()->mutex.unlock();
-    return result;
+    return size;
 }
 
-QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos) const
+QSize MicaMaterialPrivate::wallpaperSize(const QSize &monitorSize)
 {
-    if (pos.isNull()) {
+    // It's observed that QImage consumes too much memory if the image resolution is very large.
+    return (monitorSize > kMaximumPictureSize ? kMaximumPictureSize : monitorSize);
+}
+
+QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos, const BlurredWallpaper &wallpaper)
+{
+    if (pos.isNull() || wallpaper.size.isEmpty()) {
         return {};
     }
+    const Transform &transform = wallpaper.transform;
     QPointF result = pos;
     if (!qFuzzyIsNull(transform.Horizontal) && (transform.Horizontal > qreal(0))
             && !qFuzzyCompare(transform.Horizontal, qreal(1))) {
@@ -881,7 +1310,7 @@ QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos) const
             && !qFuzzyCompare(transform.Vertical, qreal(1))) {
         result.setY(result.y() * transform.Vertical);
     }
-    const QSizeF imageSize = wallpaperSize();
+    const QSizeF imageSize = wallpaper.size;
     // Make sure the position is always inside the wallpaper rectangle.
     while (result.x() < qreal(0)) {
         result.setX(result.x() + imageSize.width());
@@ -898,11 +1327,12 @@ QPoint MicaMaterialPrivate::mapToWallpaper(const QPoint &pos) const
     return result.toPoint();
 }
 
-QSize MicaMaterialPrivate::mapToWallpaper(const QSize &size) const
+QSize MicaMaterialPrivate::mapToWallpaper(const QSize &size, const BlurredWallpaper &wallpaper)
 {
     if (size.isEmpty()) {
         return {};
     }
+    const Transform &transform = wallpaper.transform;
     QSizeF result = size;
     if (!qFuzzyIsNull(transform.Horizontal) && (transform.Horizontal > qreal(0))
             && !qFuzzyCompare(transform.Horizontal, qreal(1))) {
@@ -912,7 +1342,7 @@ QSize MicaMaterialPrivate::mapToWallpaper(const QSize &size) const
             && !qFuzzyCompare(transform.Vertical, qreal(1))) {
         result.setHeight(result.height() * transform.Vertical);
     }
-    const QSizeF imageSize = wallpaperSize();
+    const QSizeF imageSize = wallpaper.size;
     // Make sure we don't get a size larger than the wallpaper's size.
     if (result.width() > imageSize.width()) {
         result.setWidth(imageSize.width());
@@ -923,10 +1353,10 @@ QSize MicaMaterialPrivate::mapToWallpaper(const QSize &size) const
     return result.toSize();
 }
 
-QRect MicaMaterialPrivate::mapToWallpaper(const QRect &rect) const
+QRect MicaMaterialPrivate::mapToWallpaper(const QRect &rect, const BlurredWallpaper &wallpaper)
 {
-    const auto wallpaperRect = QRectF{ QPointF{ 0, 0 }, wallpaperSize() };
-    const auto mappedRect = QRectF{ mapToWallpaper(rect.topLeft()), mapToWallpaper(rect.size()) };
+    const auto wallpaperRect = QRectF{ QPointF{ 0, 0 }, wallpaper.size };
+    const auto mappedRect = QRectF{ mapToWallpaper(rect.topLeft(), wallpaper), mapToWallpaper(rect.size(), wallpaper) };
     if (!Utils::isValidGeometry(mappedRect)) {
         WARNING << "The calculated mapped rectangle is not valid.";
         return wallpaperRect.toRect();
@@ -941,6 +1371,41 @@ MicaMaterial::MicaMaterial(QObject *parent)
 
 MicaMaterial::~MicaMaterial() = default;
 
+WallpaperSource *MicaMaterial::wallpaperSource()
+{
+    const QMutexLocker locker(&g_wallpaperSourceData()->mutex);
+    return g_wallpaperSourceData()->source;
+}
+
+void MicaMaterial::setWallpaperSource(WallpaperSource *source)
+{
+    {
+        const QMutexLocker locker(&g_wallpaperSourceData()->mutex);
+        if (g_wallpaperSourceData()->source == source) {
+            return;
+        }
+        if (g_wallpaperSourceData()->connection) {
+            disconnect(g_wallpaperSourceData()->connection);
+        }
+        WallpaperSource * const oldSource = g_wallpaperSourceData()->source;
+        g_wallpaperSourceData()->source = source;
+        if (source) {
+            g_wallpaperSourceData()->connection = connect(source, &WallpaperSource::changed, source, [](){
+                invalidateBlurredWallpapers();
+            });
+        }
+        // The old source may be destroyed as soon as we return, let the wallpaper
+        // thread finish using it first. New loads won't pick it up anymore.
+        if (oldSource) {
+            while (g_wallpaperSourceData()->users.contains(oldSource)) {
+                g_wallpaperSourceData()->usersChanged.wait(&g_wallpaperSourceData()->mutex);
+            }
+        }
+    }
+    // Only the wallpapers that have already been used will be rebuilt.
+    invalidateBlurredWallpapers();
+}
+
 QColor MicaMaterial::tintColor() const
 {
     Q_D(const MicaMaterial);
@@ -957,7 +1422,6 @@ void MicaMaterial::setTintColor(const QColor &value)
     if (d->tintColor == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->tintColor = value;
     d->updateMaterialBrush();
     Q_EMIT tintColorChanged();
@@ -975,7 +1439,6 @@ void MicaMaterial::setTintOpacity(const qreal value)
     if (qFuzzyCompare(d->tintOpacity, value)) {
         return;
     }
-    d->prepareGraphicsResources();
     d->tintOpacity = value;
     d->updateMaterialBrush();
     Q_EMIT tintOpacityChanged();
@@ -997,7 +1460,6 @@ void MicaMaterial::setFallbackColor(const QColor &value)
     if (d->fallbackColor == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->fallbackColor = value;
     d->updateMaterialBrush();
     Q_EMIT fallbackColorChanged();
@@ -1015,7 +1477,6 @@ void MicaMaterial::setNoiseOpacity(const qreal value)
     if (qFuzzyCompare(d->noiseOpacity, value)) {
         return;
     }
-    d->prepareGraphicsResources();
     d->noiseOpacity = value;
     d->updateMaterialBrush();
     Q_EMIT noiseOpacityChanged();
@@ -1033,7 +1494,6 @@ void MicaMaterial::setFallbackEnabled(const bool value)
     if (d->fallbackEnabled == value) {
         return;
     }
-    d->prepareGraphicsResources();
     d->fallbackEnabled = value;
     d->updateMaterialBrush();
     Q_EMIT fallbackEnabledChanged();
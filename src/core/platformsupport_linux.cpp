@@ -316,6 +316,9 @@ xcb_get_property_unchecked(
     }
 
 FRAMELESSHELPER_STRING_CONSTANT2(libgtk, "libgtk-3")
+// GLib, GObject and GIO are dependencies of GTK, but they are much cheaper to load on
+// their own. The GLib and GObject symbols are found through the dependencies of GIO.
+FRAMELESSHELPER_STRING_CONSTANT2(libgio, "libgio-2.0")
 
 FRAMELESSHELPER_STRING_CONSTANT(gtk_init)
 FRAMELESSHELPER_STRING_CONSTANT(g_value_init)
@@ -329,6 +332,12 @@ FRAMELESSHELPER_STRING_CONSTANT(g_signal_connect_data)
 FRAMELESSHELPER_STRING_CONSTANT(g_free)
 FRAMELESSHELPER_STRING_CONSTANT(g_object_unref)
 FRAMELESSHELPER_STRING_CONSTANT(g_clear_object)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_schema_source_get_default)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_schema_source_lookup)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_schema_has_key)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_schema_unref)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_new)
+FRAMELESSHELPER_STRING_CONSTANT(g_settings_get_string)
 
 extern "C" void
 gtk_init(
@@ -348,10 +357,10 @@ g_value_init(
     GType g_type
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_init)) {
+    if (!API_GIO_AVAILABLE(g_value_init)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_init, value, g_type);
+    return API_CALL_FUNCTION(libgio, g_value_init, value, g_type);
 }
 
 extern "C" GValue *
@@ -359,10 +368,10 @@ g_value_reset(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_reset)) {
+    if (!API_GIO_AVAILABLE(g_value_reset)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_reset, value);
+    return API_CALL_FUNCTION(libgio, g_value_reset, value);
 }
 
 extern "C" void
@@ -370,10 +379,10 @@ g_value_unset(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_unset)) {
+    if (!API_GIO_AVAILABLE(g_value_unset)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_value_unset, value);
+    API_CALL_FUNCTION(libgio, g_value_unset, value);
 }
 
 extern "C" gboolean
@@ -381,10 +390,10 @@ g_value_get_boolean(
     const GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_get_boolean)) {
+    if (!API_GIO_AVAILABLE(g_value_get_boolean)) {
         return false;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_get_boolean, value);
+    return API_CALL_FUNCTION(libgio, g_value_get_boolean, value);
 }
 
 extern "C" const gchar *
@@ -392,10 +401,10 @@ g_value_get_string(
     const GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_value_get_string)) {
+    if (!API_GIO_AVAILABLE(g_value_get_string)) {
         return nullptr;
     }
-    return API_CALL_FUNCTION(libgtk, g_value_get_string, value);
+    return API_CALL_FUNCTION(libgio, g_value_get_string, value);
 }
 
 extern "C" GtkSettings *
@@ -416,10 +425,10 @@ g_object_get_property(
     GValue *value
 )
 {
-    if (!API_GTK_AVAILABLE(g_object_get_property)) {
+    if (!API_GIO_AVAILABLE(g_object_get_property)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_object_get_property, object, property_name, value);
+    API_CALL_FUNCTION(libgio, g_object_get_property, object, property_name, value);
 }
 
 extern "C" gulong
@@ -432,10 +441,10 @@ g_signal_connect_data(
     GConnectFlags connect_flags
 )
 {
-    if (!API_GTK_AVAILABLE(g_signal_connect_data)) {
+    if (!API_GIO_AVAILABLE(g_signal_connect_data)) {
         return 0;
     }
-    return API_CALL_FUNCTION(libgtk, g_signal_connect_data, instance, detailed_signal, c_handler, data, destroy_data, connect_flags);
+    return API_CALL_FUNCTION(libgio, g_signal_connect_data, instance, detailed_signal, c_handler, data, destroy_data, connect_flags);
 }
 
 extern "C" void
@@ -443,10 +452,10 @@ g_free(
     gpointer mem
 )
 {
-    if (!API_GTK_AVAILABLE(g_free)) {
+    if (!API_GIO_AVAILABLE(g_free)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_free, mem);
+    API_CALL_FUNCTION(libgio, g_free, mem);
 }
 
 extern "C" void
@@ -454,10 +463,10 @@ g_object_unref(
     GObject *object
 )
 {
-    if (!API_GTK_AVAILABLE(g_object_unref)) {
+    if (!API_GIO_AVAILABLE(g_object_unref)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_object_unref, object);
+    API_CALL_FUNCTION(libgio, g_object_unref, object);
 }
 
 extern "C" void
@@ -465,10 +474,80 @@ g_clear_object(
     GObject **object_ptr
 )
 {
-    if (!API_GTK_AVAILABLE(g_clear_object)) {
+    if (!API_GIO_AVAILABLE(g_clear_object)) {
         return;
     }
-    API_CALL_FUNCTION(libgtk, g_clear_object, object_ptr);
+    API_CALL_FUNCTION(libgio, g_clear_object, object_ptr);
+}
+
+extern "C" GSettingsSchemaSource *
+g_settings_schema_source_get_default(
+    void
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_schema_source_get_default)) {
+        return nullptr;
+    }
+    return API_CALL_FUNCTION(libgio, g_settings_schema_source_get_default);
+}
+
+extern "C" GSettingsSchema *
+g_settings_schema_source_lookup(
+    GSettingsSchemaSource *source,
+    const gchar *schema_id,
+    gboolean recursive
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_schema_source_lookup)) {
+        return nullptr;
+    }
+    return API_CALL_FUNCTION(libgio, g_settings_schema_source_lookup, source, schema_id, recursive);
+}
+
+extern "C" gboolean
+g_settings_schema_has_key(
+    GSettingsSchema *schema,
+    const gchar *name
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_schema_has_key)) {
+        return false;
+    }
+    return API_CALL_FUNCTION(libgio, g_settings_schema_has_key, schema, name);
+}
+
+extern "C" void
+g_settings_schema_unref(
+    GSettingsSchema *schema
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_schema_unref)) {
+        return;
+    }
+    API_CALL_FUNCTION(libgio, g_settings_schema_unref, schema);
+}
+
+extern "C" GSettings *
+g_settings_new(
+    const gchar *schema_id
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_new)) {
+        return nullptr;
+    }
+    return API_CALL_FUNCTION(libgio, g_settings_new, schema_id);
+}
+
+extern "C" gchar *
+g_settings_get_string(
+    GSettings *settings,
+    const gchar *key
+)
+{
+    if (!API_GIO_AVAILABLE(g_settings_get_string)) {
+        return nullptr;
+    }
+    return API_CALL_FUNCTION(libgio, g_settings_get_string, settings, key);
 }
 
 GTKSETTINGS_IMPL(bool, const bool result = g_value_get_boolean(&value);)
@@ -477,6 +556,23 @@ GTKSETTINGS_IMPL(QString, const QString result = QUtf8String(g_value_get_string(
 #endif // FRAMELESSHELPER_HAS_GTK
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
+SysApiLoader::PreloadManifest sysApiPreloadManifest()
+{
+    SysApiLoader::PreloadManifest manifest = {};
+#ifndef FRAMELESSHELPER_HAS_XCB
+    manifest.append({klibxcb, {
+        kxcb_send_event, kxcb_flush, kxcb_intern_atom, kxcb_intern_atom_reply,
+        kxcb_ungrab_pointer, kxcb_change_property, kxcb_delete_property_checked,
+        kxcb_get_property, kxcb_get_property_reply, kxcb_get_property_value,
+        kxcb_get_property_value_length, kxcb_list_properties, kxcb_list_properties_reply,
+        kxcb_list_properties_atoms_length, kxcb_list_properties_atoms, kxcb_get_property_unchecked
+    }});
+#endif // FRAMELESSHELPER_HAS_XCB
+    // GTK is left out on purpose: it's only the fallback when the desktop portal isn't
+    // available, so it's resolved the first time that path actually needs it.
+    return manifest;
+}
+
 template<typename T>
 T gtkSettings(const gchar *property)
 {
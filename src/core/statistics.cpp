@@ -0,0 +1,192 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "statistics_p.h"
+#include <QtCore/qmutex.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+static constexpr const auto kCounterCount = (int(StatisticsRecorder::Counter::Last) + 1);
+static constexpr const auto kHistogramCount = (int(StatisticsRecorder::Histogram::Last) + 1);
+
+struct ThreadHistogram
+{
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> totalNsecs{0};
+    std::atomic<quint64> maxNsecs{0};
+    std::array<std::atomic<quint64>, LatencyHistogram::BucketCount> buckets = {};
+};
+
+struct ThreadStatistics
+{
+    std::array<std::atomic<quint64>, kCounterCount> counters = {};
+    std::array<ThreadHistogram, kHistogramCount> histograms = {};
+};
+
+struct StatisticsData
+{
+    QMutex mutex{};
+    std::vector<const ThreadStatistics *> threads = {};
+    // What the threads which have already finished left behind.
+    std::array<quint64, kCounterCount> retiredCounters = {};
+    std::array<LatencyHistogram, kHistogramCount> retiredHistograms = {};
+};
+
+Q_GLOBAL_STATIC(StatisticsData, g_statisticsData)
+
+// Only the owning thread ever writes, so a relaxed load and store is enough,
+// no need for the (much more expensive) atomic read-modify-write operations.
+static inline void increase(std::atomic<quint64> &value, const quint64 delta)
+{
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+static inline void accumulate(LatencyHistogram &target, const ThreadHistogram &source)
+{
+    target.count += source.count.load(std::memory_order_relaxed);
+    target.totalNsecs += source.totalNsecs.load(std::memory_order_relaxed);
+    target.maxNsecs = qMax(target.maxNsecs, source.maxNsecs.load(std::memory_order_relaxed));
+    for (int i = 0; i != LatencyHistogram::BucketCount; ++i) {
+        target.buckets[i] += source.buckets.at(i).load(std::memory_order_relaxed);
+    }
+}
+
+class ThreadStatisticsHolder
+{
+    Q_DISABLE_COPY_MOVE(ThreadStatisticsHolder)
+
+public:
+    explicit ThreadStatisticsHolder()
+    {
+        StatisticsData * const data = g_statisticsData();
+        const QMutexLocker locker(&data->mutex);
+        data->threads.push_back(&m_statistics);
+    }
+
+    ~ThreadStatisticsHolder()
+    {
+        if (g_statisticsData.isDestroyed()) {
+            return;
+        }
+        StatisticsData * const data = g_statisticsData();
+        const QMutexLocker locker(&data->mutex);
+        for (int i = 0; i != kCounterCount; ++i) {
+            data->retiredCounters[i] += m_statistics.counters.at(i).load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i != kHistogramCount; ++i) {
+            accumulate(data->retiredHistograms[i], m_statistics.histograms.at(i));
+        }
+        data->threads.erase(std::remove(data->threads.begin(), data->threads.end(), &m_statistics), data->threads.end());
+    }
+
+    Q_NODISCARD ThreadStatistics *statistics()
+    {
+        return &m_statistics;
+    }
+
+private:
+    ThreadStatistics m_statistics = {};
+};
+
+[[nodiscard]] static inline ThreadStatistics *threadStatistics()
+{
+    static thread_local ThreadStatisticsHolder holder;
+    return holder.statistics();
+}
+
+[[nodiscard]] static inline int bucketIndex(const qint64 nsecs)
+{
+    qint64 bound = 1000; // 1us
+    for (int i = 0; i != (LatencyHistogram::BucketCount - 1); ++i) {
+        if (nsecs < bound) {
+            return i;
+        }
+        bound *= 10;
+    }
+    return (LatencyHistogram::BucketCount - 1);
+}
+
+void StatisticsRecorder::add(const Counter counter, const qint64 delta)
+{
+    // The gauges rely on the unsigned wrap around, the sum is still correct in the end.
+    increase(threadStatistics()->counters[int(counter)], quint64(delta));
+}
+
+void StatisticsRecorder::record(const Histogram histogram, const qint64 nsecs)
+{
+    const auto value = quint64(qMax(qint64(0), nsecs));
+    ThreadHistogram &target = threadStatistics()->histograms[int(histogram)];
+    increase(target.count, 1);
+    increase(target.totalNsecs, value);
+    if (value > target.maxNsecs.load(std::memory_order_relaxed)) {
+        target.maxNsecs.store(value, std::memory_order_relaxed);
+    }
+    increase(target.buckets[bucketIndex(qint64(value))], 1);
+}
+
+RuntimeStatistics StatisticsRecorder::snapshot()
+{
+    std::array<quint64, kCounterCount> counters = {};
+    std::array<LatencyHistogram, kHistogramCount> histograms = {};
+    {
+        StatisticsData * const data = g_statisticsData();
+        const QMutexLocker locker(&data->mutex);
+        counters = data->retiredCounters;
+        histograms = data->retiredHistograms;
+        for (auto &&thread : std::as_const(data->threads)) {
+            for (int i = 0; i != kCounterCount; ++i) {
+                counters[i] += thread->counters.at(i).load(std::memory_order_relaxed);
+            }
+            for (int i = 0; i != kHistogramCount; ++i) {
+                accumulate(histograms[i], thread->histograms.at(i));
+            }
+        }
+    }
+    const auto counterValue = [&counters](const Counter counter) -> quint64 {
+        return counters.at(int(counter));
+    };
+    RuntimeStatistics result = {};
+    result.wallpaperRebuildsRequested = counterValue(Counter::WallpaperRebuildRequested);
+    result.wallpaperRebuildsCoalesced = counterValue(Counter::WallpaperRebuildCoalesced);
+    result.wallpaperRebuildsCompleted = counterValue(Counter::WallpaperRebuildCompleted);
+    result.wallpaperRebuildsCancelled = counterValue(Counter::WallpaperRebuildCancelled);
+    result.blurDuration = histograms.at(int(Histogram::BlurDuration));
+    result.micaPaints = counterValue(Counter::MicaPaint);
+    result.micaPixelsBlitted = counterValue(Counter::MicaPixelBlitted);
+    result.micaBrushRegenerations = counterValue(Counter::MicaBrushRegeneration);
+    result.hitTests = histograms.at(int(Histogram::HitTest));
+    result.themeQueries = counterValue(Counter::ThemeQuery);
+    result.cursorUpdates = counterValue(Counter::CursorUpdate);
+    result.qtWindows = counterValue(Counter::QtWindow);
+    result.win32Windows = counterValue(Counter::Win32Window);
+    return result;
+}
+
+FRAMELESSHELPER_END_NAMESPACE
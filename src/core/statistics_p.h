@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/statistics_p.h"
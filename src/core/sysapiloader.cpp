@@ -48,6 +48,10 @@
 #include <QtCore/qloggingcategory.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qvarlengtharray.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qreadwritelock.h>
+#include <QtCore/qthread.h>
+#include <memory>
 #if SYSAPILOADER_QSYSTEMLIBRARY
 #  include <QtCore/private/qsystemlibrary_p.h>
 #endif // SYSAPILOADER_QSYSTEMLIBRARY
@@ -71,7 +75,21 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 #  define CRITICAL qCCritical(lcSysApiLoader)
 #endif
 
-using SysApiLoaderData = QHash<QString, QFunctionPointer>;
+struct SysApiLoaderData
+{
+    QReadWriteLock lock;
+    QHash<QString, QFunctionPointer> functions = {};
+    QMutex preloadMutex;
+    std::unique_ptr<QThread> preloadThread = nullptr;
+
+    ~SysApiLoaderData()
+    {
+        // Never destroy a running thread.
+        if (preloadThread) {
+            preloadThread->wait();
+        }
+    }
+};
 
 Q_GLOBAL_STATIC(SysApiLoaderData, g_sysApiLoaderData)
 
@@ -185,25 +203,33 @@ bool SysApiLoader::isAvailable(const QString &library, const QString &function)
         return false;
     }
     const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
-        if (isDebug()) {
-            DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
+    {
+        const QReadLocker locker(&g_sysApiLoaderData()->lock);
+        const auto it = g_sysApiLoaderData()->functions.constFind(key);
+        if (it != g_sysApiLoaderData()->functions.constEnd()) {
+            if (isDebug()) {
+                DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
+            }
+            return (it.value() != nullptr);
         }
-        return (it.value() != nullptr);
+    }
+    // Don't hold the lock while resolving, loading the library can take a while.
+    // If another thread resolves the same function in the meantime, it will get
+    // the same result anyway, so the duplicated insertion is harmless.
+    const QFunctionPointer symbol = SysApiLoader::resolve(library, function);
+    {
+        const QWriteLocker locker(&g_sysApiLoaderData()->lock);
+        g_sysApiLoaderData()->functions.insert(key, symbol);
+    }
+    if (isDebug()) {
+        DEBUG << Q_FUNC_INFO << "New function cache:" << key << (symbol ? "[VALID]" : "[NULL]");
+    }
+    if (symbol) {
+        DEBUG << "Successfully loaded" << function << "from" << library;
+        return true;
     } else {
-        const QFunctionPointer symbol = SysApiLoader::resolve(library, function);
-        g_sysApiLoaderData()->insert(key, symbol);
-        if (isDebug()) {
-            DEBUG << Q_FUNC_INFO << "New function cache:" << key << (symbol ? "[VALID]" : "[NULL]");
-        }
-        if (symbol) {
-            DEBUG << "Successfully loaded" << function << "from" << library;
-            return true;
-        } else {
-            WARNING << "Failed to load" << function << "from" << library;
-            return false;
-        }
+        WARNING << "Failed to load" << function << "from" << library;
+        return false;
     }
 }
 
@@ -215,8 +241,9 @@ QFunctionPointer SysApiLoader::get(const QString &library, const QString &functi
         return nullptr;
     }
     const QString key = generateUniqueKey(library, function);
-    const auto it = g_sysApiLoaderData()->constFind(key);
-    if (it != g_sysApiLoaderData()->constEnd()) {
+    const QReadLocker locker(&g_sysApiLoaderData()->lock);
+    const auto it = g_sysApiLoaderData()->functions.constFind(key);
+    if (it != g_sysApiLoaderData()->functions.constEnd()) {
         if (isDebug()) {
             DEBUG << Q_FUNC_INFO << "Function cache found:" << key;
         }
@@ -229,4 +256,36 @@ QFunctionPointer SysApiLoader::get(const QString &library, const QString &functi
     }
 }
 
+void SysApiLoader::preload(const PreloadManifest &manifest)
+{
+    if (manifest.isEmpty()) {
+        return;
+    }
+    const QMutexLocker locker(&g_sysApiLoaderData()->preloadMutex);
+    if (g_sysApiLoaderData()->preloadThread) {
+        WARNING << "The system API preloading has already been started.";
+        return;
+    }
+    // Loading the system libraries is not free, do it in the background so that
+    // the first user interaction won't have to wait for the dynamic linker.
+    g_sysApiLoaderData()->preloadThread.reset(QThread::create([manifest](){
+        SysApiLoader * const loader = SysApiLoader::instance();
+        for (auto &&item : std::as_const(manifest)) {
+            for (auto &&function : std::as_const(item.second)) {
+                std::ignore = loader->isAvailable(item.first, function);
+            }
+        }
+    }));
+    g_sysApiLoaderData()->preloadThread->setObjectName(FRAMELESSHELPER_STRING_LITERAL("SysApiPreloadThread"));
+    g_sysApiLoaderData()->preloadThread->start(QThread::LowPriority);
+}
+
+void SysApiLoader::waitForPreload()
+{
+    const QMutexLocker locker(&g_sysApiLoaderData()->preloadMutex);
+    if (g_sysApiLoaderData()->preloadThread) {
+        g_sysApiLoaderData()->preloadThread->wait();
+    }
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,239 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tracing_p.h"
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthread.h>
+#include <vector>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcTracing, "wangwenx190.framelesshelper.core.tracing")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcTracing)
+#  define DEBUG qCDebug(lcTracing)
+#  define WARNING qCWarning(lcTracing)
+#  define CRITICAL qCCritical(lcTracing)
+#endif
+
+using namespace Global;
+
+FRAMELESSHELPER_BYTEARRAY_CONSTANT2(TraceFileVar, "FRAMELESSHELPER_TRACE_FILE")
+
+// Write the events out in batches, the file should stay usable even if the application crashes.
+[[maybe_unused]] static constexpr const std::size_t kFlushThreshold = 4096;
+
+struct TraceEvent
+{
+    const char *category = nullptr;
+    const char *name = nullptr;
+    char phase = 'X';
+    qint64 start = 0; // nanoseconds
+    qint64 duration = 0; // nanoseconds
+    quint64 threadId = 0;
+    QByteArray threadName = {}; // only for the thread name metadata events
+};
+
+struct TracerData
+{
+    QMutex mutex{};
+    QElapsedTimer timer{};
+    QFile file{};
+    std::vector<TraceEvent> events = {};
+    qint64 processId = 0;
+    bool firstEvent = true;
+
+    ~TracerData()
+    {
+        const QMutexLocker locker(&mutex);
+        if (!file.isOpen()) {
+            return;
+        }
+        writeEvents();
+        file.write("\n]\n");
+        file.close();
+    }
+
+    void writeEvents()
+    {
+        if (events.empty() || !file.isOpen()) {
+            return;
+        }
+        QByteArray buffer = {};
+        buffer.reserve(int(events.size() * 128));
+        const QByteArray pid = QByteArray::number(processId);
+        for (auto &&event : std::as_const(events)) {
+            buffer.append(firstEvent ? "" : ",\n");
+            firstEvent = false;
+            const QByteArray tid = QByteArray::number(event.threadId);
+            if (event.phase == 'M') {
+                buffer.append(R"({"name":"thread_name","ph":"M","pid":)" + pid + R"(,"tid":)" + tid
+                    + R"(,"args":{"name":")" + event.threadName + R"("}})");
+                continue;
+            }
+            buffer.append(R"({"name":")");
+            buffer.append(event.name);
+            buffer.append(R"(","cat":")");
+            buffer.append(event.category);
+            buffer.append(R"(","ph":")");
+            buffer.append(event.phase);
+            // The timestamps are in microseconds.
+            buffer.append(R"(","ts":)" + QByteArray::number((double(event.start) / 1000.0), 'f', 3));
+            if (event.phase == 'X') {
+                buffer.append(R"(,"dur":)" + QByteArray::number((double(event.duration) / 1000.0), 'f', 3));
+            } else {
+                buffer.append(R"(,"s":"t")");
+            }
+            buffer.append(R"(,"pid":)" + pid + R"(,"tid":)" + tid + '}');
+        }
+        events.clear();
+        file.write(buffer);
+        file.flush();
+    }
+};
+
+Q_GLOBAL_STATIC(TracerData, g_tracerData)
+
+[[nodiscard]] static inline QByteArray escapedThreadName()
+{
+    QString name = {};
+    if (QThread * const thread = QThread::currentThread()) {
+        name = thread->objectName();
+        if (name.isEmpty()) {
+            const QCoreApplication * const app = QCoreApplication::instance();
+            if (app && (app->thread() == thread)) {
+                name = QStringLiteral("Main thread");
+            } else {
+                name = QString::fromLatin1(thread->metaObject()->className());
+            }
+        }
+    }
+    QByteArray result = name.toUtf8();
+    result.replace('\\', "\\\\");
+    result.replace('"', "\\\"");
+    return result;
+}
+
+static inline void appendEvent(TraceEvent &&event)
+{
+    // Give every thread a readable name in the viewer, the first time we see it.
+    static thread_local bool threadNamed = false;
+    const auto threadId = quint64(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+    event.threadId = threadId;
+    TracerData * const data = g_tracerData();
+    const QMutexLocker locker(&data->mutex);
+    if (!threadNamed) {
+        threadNamed = true;
+        TraceEvent metadata = {};
+        metadata.phase = 'M';
+        metadata.threadId = threadId;
+        metadata.threadName = escapedThreadName();
+        data->events.push_back(std::move(metadata));
+    }
+    data->events.push_back(std::move(event));
+    if (data->events.size() >= kFlushThreshold) {
+        data->writeEvents();
+    }
+}
+
+bool Tracer::isEnabled()
+{
+    static const bool enabled = []() -> bool {
+        const QString filePath = qEnvironmentVariable(kTraceFileVar);
+        if (filePath.isEmpty()) {
+            return false;
+        }
+        TracerData * const data = g_tracerData();
+        const QMutexLocker locker(&data->mutex);
+        data->file.setFileName(filePath);
+        if (!data->file.open(QFile::WriteOnly | QFile::Truncate)) {
+            WARNING << "Failed to open the trace file:" << data->file.errorString();
+            return false;
+        }
+        data->file.write("[\n");
+        data->processId = QCoreApplication::applicationPid();
+        data->timer.start();
+        INFO << "Tracing enabled, writing to" << filePath;
+        return true;
+    }();
+    return enabled;
+}
+
+qint64 Tracer::timestamp()
+{
+    return g_tracerData()->timer.nsecsElapsed();
+}
+
+void Tracer::addCompleteEvent(const char *category, const char *name, const qint64 start, const qint64 end)
+{
+    Q_ASSERT(category);
+    Q_ASSERT(name);
+    if (!category || !name || !isEnabled()) {
+        return;
+    }
+    TraceEvent event = {};
+    event.category = category;
+    event.name = name;
+    event.phase = 'X';
+    event.start = start;
+    event.duration = qMax(qint64(0), (end - start));
+    appendEvent(std::move(event));
+}
+
+void Tracer::addInstantEvent(const char *category, const char *name)
+{
+    Q_ASSERT(category);
+    Q_ASSERT(name);
+    if (!category || !name || !isEnabled()) {
+        return;
+    }
+    TraceEvent event = {};
+    event.category = category;
+    event.name = name;
+    event.phase = 'i';
+    event.start = timestamp();
+    appendEvent(std::move(event));
+}
+
+void Tracer::flush()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    TracerData * const data = g_tracerData();
+    const QMutexLocker locker(&data->mutex);
+    data->writeEvents();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/tracing_p.h"
@@ -117,22 +117,17 @@ Qt::CursorShape Utils::calculateCursorShape(const QWindow *window, const QPoint
     if (window->visibility() != QWindow::Windowed) {
         return Qt::ArrowCursor;
     }
-    const int x = pos.x();
-    const int y = pos.y();
-    const int w = window->width();
-    const int h = window->height();
-    if (((x < kDefaultResizeBorderThickness) && (y < kDefaultResizeBorderThickness))
-        || ((x >= (w - kDefaultResizeBorderThickness)) && (y >= (h - kDefaultResizeBorderThickness)))) {
+    const Qt::Edges edges = calculateWindowEdges(window, pos);
+    if ((edges == (Qt::LeftEdge | Qt::TopEdge)) || (edges == (Qt::RightEdge | Qt::BottomEdge))) {
         return Qt::SizeFDiagCursor;
     }
-    if (((x >= (w - kDefaultResizeBorderThickness)) && (y < kDefaultResizeBorderThickness))
-        || ((x < kDefaultResizeBorderThickness) && (y >= (h - kDefaultResizeBorderThickness)))) {
+    if ((edges == (Qt::RightEdge | Qt::TopEdge)) || (edges == (Qt::LeftEdge | Qt::BottomEdge))) {
         return Qt::SizeBDiagCursor;
     }
-    if ((x < kDefaultResizeBorderThickness) || (x >= (w - kDefaultResizeBorderThickness))) {
+    if ((edges & Qt::LeftEdge) || (edges & Qt::RightEdge)) {
         return Qt::SizeHorCursor;
     }
-    if ((y < kDefaultResizeBorderThickness) || (y >= (h - kDefaultResizeBorderThickness))) {
+    if ((edges & Qt::TopEdge) || (edges & Qt::BottomEdge)) {
         return Qt::SizeVerCursor;
     }
     return Qt::ArrowCursor;
@@ -153,25 +148,42 @@ Qt::Edges Utils::calculateWindowEdges(const QWindow *window, const QPoint &pos)
     if (window->visibility() != QWindow::Windowed) {
         return {};
     }
+    // The resize area starts where the visible window starts, not at the outer edge of
+    // the (input transparent) shadow around it. It also reaches into the shadow, as far
+    // as the input region of the window does.
+    const QMargins margins = windowShadowMargins(window);
     Qt::Edges edges = {};
     const int x = pos.x();
     const int y = pos.y();
-    if (x < kDefaultResizeBorderThickness) {
+    if (x < (margins.left() + kDefaultResizeBorderThickness)) {
         edges |= Qt::LeftEdge;
     }
-    if (x >= (window->width() - kDefaultResizeBorderThickness)) {
+    if (x >= (window->width() - margins.right() - kDefaultResizeBorderThickness)) {
         edges |= Qt::RightEdge;
     }
-    if (y < kDefaultResizeBorderThickness) {
+    if (y < (margins.top() + kDefaultResizeBorderThickness)) {
         edges |= Qt::TopEdge;
     }
-    if (y >= (window->height() - kDefaultResizeBorderThickness)) {
+    if (y >= (window->height() - margins.bottom() - kDefaultResizeBorderThickness)) {
         edges |= Qt::BottomEdge;
     }
     return edges;
 #endif
 }
 
+QMargins Utils::windowShadowMargins(const QWindow *window)
+{
+    Q_ASSERT(window);
+    if (!window) {
+        return {};
+    }
+    const QVariant marginsVar = window->property(kWindowShadowMarginsProperty);
+    if (!marginsVar.isValid()) {
+        return {};
+    }
+    return qvariant_cast<QMargins>(marginsVar);
+}
+
 QString Utils::getSystemButtonGlyph(const SystemButtonType button)
 {
 #ifdef FRAMELESSHELPER_CORE_NO_BUNDLE_RESOURCE
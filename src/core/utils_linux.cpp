@@ -26,8 +26,14 @@
 #include "framelessconfig_p.h"
 #include "framelessmanager.h"
 #include "framelessmanager_p.h"
+#include "desktopportalsettings_p.h"
+#include "desktopwallpaperwatcher_p.h"
+#include "sysapiloader_p.h"
 #include <cstring> // for std::memcpy
+#include <array>
+#include <optional>
 #include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
 #include <QtGui/qevent.h>
 #include <QtGui/qwindow.h>
 #include <QtGui/qscreen.h>
@@ -82,6 +88,55 @@ FRAMELESSHELPER_BYTEARRAY_CONSTANT(startupid)
 FRAMELESSHELPER_BYTEARRAY_CONSTANT(display)
 FRAMELESSHELPER_BYTEARRAY_CONSTANT(connection)
 
+// The shape extension lives in its own library, which Qt's xcb plugin
+// always loads, so we look it up at runtime instead of linking to it.
+FRAMELESSHELPER_STRING_CONSTANT2(libxcbshape, "libxcb-shape")
+FRAMELESSHELPER_STRING_CONSTANT(xcb_shape_rectangles)
+FRAMELESSHELPER_STRING_CONSTANT(xcb_shape_mask)
+
+// From <xcb/shape.h>
+[[maybe_unused]] static constexpr const uint8_t kXcbShapeSoSet = 0;
+[[maybe_unused]] static constexpr const uint8_t kXcbShapeSkInput = 2;
+[[maybe_unused]] static constexpr const uint8_t kXcbClipOrderingUnsorted = 0;
+
+using xcb_shape_rectangles_ptr = xcb_void_cookie_t(*)(xcb_connection_t *, uint8_t, uint8_t,
+    uint8_t, xcb_window_t, int16_t, int16_t, uint32_t, const xcb_rectangle_t *);
+using xcb_shape_mask_ptr = xcb_void_cookie_t(*)(xcb_connection_t *, uint8_t, uint8_t,
+    xcb_window_t, int16_t, int16_t, uint32_t);
+
+[[maybe_unused]] static constexpr const char *kX11AtomNames[] = {
+    ATOM_NET_SUPPORTED,
+    ATOM_NET_WM_NAME,
+    ATOM_NET_WM_MOVERESIZE,
+    ATOM_NET_SUPPORTING_WM_CHECK,
+    ATOM_NET_KDE_COMPOSITE_TOGGLING,
+    ATOM_KDE_NET_WM_BLUR_BEHIND_REGION,
+    ATOM_GTK_SHOW_WINDOW_MENU,
+    ATOM_GTK_FRAME_EXTENTS,
+    ATOM_DEEPIN_NO_TITLEBAR,
+    ATOM_DEEPIN_FORCE_DECORATE,
+    ATOM_NET_WM_DEEPIN_BLUR_REGION_MASK,
+    ATOM_NET_WM_DEEPIN_BLUR_REGION_ROUNDED,
+    ATOM_UTF8_STRING
+};
+static_assert(std::size(kX11AtomNames) == (static_cast<int>(X11Atom::Last) + 1));
+
+struct X11Context
+{
+    xcb_connection_t *connection = nullptr;
+    int screen = 0;
+    xcb_window_t rootWindow = XCB_NONE;
+};
+
+struct X11ContextData
+{
+    QMutex mutex;
+    std::optional<X11Context> context = std::nullopt;
+    bool screenChangeMonitored = false;
+};
+
+Q_GLOBAL_STATIC(X11ContextData, g_x11ContextData)
+
 static constexpr const auto _XCB_SEND_EVENT_MASK =
     (XCB_EVENT_MASK_SUBSTRUCTURE_REDIRECT | XCB_EVENT_MASK_SUBSTRUCTURE_NOTIFY);
 
@@ -141,6 +196,38 @@ extern QString gtkSettings(const gchar *);
     QGuiApplication::sendEvent(window, event.get());
 }
 
+[[nodiscard]] static inline X11Context x11Context()
+{
+    // Querying these through the platform native interface involves several
+    // string comparisons each time, and we need them on every drag and every
+    // property write, so remember them until the screen configuration changes.
+    const QMutexLocker locker(&g_x11ContextData()->mutex);
+    if (g_x11ContextData()->context.has_value()) {
+        return g_x11ContextData()->context.value();
+    }
+    X11Context context = {};
+    context.connection = Utils::x11_connection();
+    context.screen = Utils::x11_appScreen();
+    context.rootWindow = Utils::x11_appRootWindow(context.screen);
+    // Without a QGuiApplication instance we can't get anything meaningful,
+    // and we also have no way to know when to refresh, so don't cache it.
+    if (!qApp) {
+        return context;
+    }
+    if (!g_x11ContextData()->screenChangeMonitored) {
+        g_x11ContextData()->screenChangeMonitored = true;
+        const auto invalidate = [](){
+            const QMutexLocker locker(&g_x11ContextData()->mutex);
+            g_x11ContextData()->context = std::nullopt;
+        };
+        QObject::connect(qApp, &QGuiApplication::screenAdded, qApp, invalidate);
+        QObject::connect(qApp, &QGuiApplication::screenRemoved, qApp, invalidate);
+        QObject::connect(qApp, &QGuiApplication::primaryScreenChanged, qApp, invalidate);
+    }
+    g_x11ContextData()->context = context;
+    return context;
+}
+
 QScreen *Utils::x11_findScreenForVirtualDesktop(const int virtualDesktopNumber)
 {
 #ifdef FRAMELESSHELPER_CORE_NO_PRIVATE
@@ -407,7 +494,9 @@ bool Utils::isTitleBarColorized()
 
 QColor Utils::getAccentColor_linux()
 {
-    // ### TODO
+    if (const auto accentColor = DesktopPortalSettings::instance()->accentColor()) {
+        return accentColor.value();
+    }
     return QGuiApplication::palette().color(QPalette::Highlight);
 }
 
@@ -431,6 +520,24 @@ bool Utils::shouldAppsUseDarkMode_linux()
         return envThemeName.contains(kdark, Qt::CaseInsensitive);
     }
 
+    /*
+        https://flatpak.github.io/xdg-desktop-portal/docs/doc-org.freedesktop.portal.Settings.html
+
+        The "color-scheme" key of the appearance namespace is the only standard,
+        desktop agnostic way to query this. It's also much cheaper than loading
+        GTK, so GTK is only consulted when there's no portal at all. "No preference"
+        means the default appearance, which is light.
+    */
+    const DesktopPortalSettings * const portalSettings = DesktopPortalSettings::instance();
+    if (!portalSettings->isInitialized()) {
+        // Don't load GTK just because the portal hasn't answered yet,
+        // FramelessManager asks again once it has.
+        return false;
+    }
+    if (portalSettings->isAvailable()) {
+        return (portalSettings->colorScheme() == DesktopPortalSettings::ColorScheme::PreferDark);
+    }
+
     /*
         https://docs.gtk.org/gtk3/property.Settings.gtk-application-prefer-dark-theme.html
 
@@ -461,12 +568,12 @@ bool Utils::setBlurBehindWindowEnabled(const WId windowId, const BlurMode mode,
     if (!windowId) {
         return false;
     }
-    static const xcb_atom_t atom = internAtom(ATOM_KDE_NET_WM_BLUR_BEHIND_REGION);
+    const xcb_atom_t atom = x11_atom(X11Atom::KDE_NET_WM_BLUR_BEHIND_REGION);
     if ((atom == XCB_NONE) || !isSupportedByRootWindow(atom)) {
         WARNING << "Current window manager doesn't support blur behind window.";
         return false;
     }
-    static const xcb_atom_t deepinAtom = internAtom(ATOM_NET_WM_DEEPIN_BLUR_REGION_MASK);
+    const xcb_atom_t deepinAtom = x11_atom(X11Atom::NET_WM_DEEPIN_BLUR_REGION_MASK);
     if ((deepinAtom != XCB_NONE) && isSupportedByWindowManager(deepinAtom)) {
         clearWindowProperty(windowId, deepinAtom);
     }
@@ -488,58 +595,14 @@ bool Utils::setBlurBehindWindowEnabled(const WId windowId, const BlurMode mode,
 
 QString Utils::getWallpaperFilePath()
 {
-#if 0
-    GConfClient * const client = gconf_client_get_default();
-    Q_ASSERT(client);
-    if (!client) {
-        return {};
-    }
-    const gchararray rawPath = gconf_client_get_string(client, "/desktop/gnome/background/picture_filename", nullptr);
-    if (!rawPath || (*rawPath == '\0')) {
-        WARNING << "Failed to retrieve the wallpaper file path.";
-        return {};
-    }
-    return QUtf8String(rawPath);
-#else
-    // ### TODO
-    return {};
-#endif
+    FramelessManagerPrivate::ensureWallpaperWatcher();
+    return DesktopWallpaperWatcher::instance()->wallpaper();
 }
 
 WallpaperAspectStyle Utils::getWallpaperAspectStyle()
 {
-#if 0
-    static constexpr const auto defaultAspectStyle = WallpaperAspectStyle::Fill;
-    GConfClient * const client = gconf_client_get_default();
-    Q_ASSERT(client);
-    if (!client) {
-        return defaultAspectStyle;
-    }
-    const gchararray rawOptions = gconf_client_get_string(client, "/desktop/gnome/background/picture_options", nullptr);
-    if (!rawOptions || (*rawOptions == '\0')) {
-        WARNING << "Failed to retrieve the wallpaper tile options.";
-        return defaultAspectStyle;
-    }
-    const QString options = QUtf8String(rawOptions);
-    if (options.isEmpty()) {
-        return defaultAspectStyle;
-    } else {
-        if ((options == u"wallpaper"_s) || (options == u"tiled"_s)) {
-            return WallpaperAspectStyle::Tile;
-        } else if (options == u"centered"_s) {
-            return WallpaperAspectStyle::Center;
-        } else if (options == u"stretched"_s) {
-            return WallpaperAspectStyle::Stretch;
-        } else if (options == u"scaled"_s) {
-            return WallpaperAspectStyle::Fit;
-        } else {
-            return defaultAspectStyle;
-        }
-    }
-#else
-    // ### TODO
-    return WallpaperAspectStyle::Fill;
-#endif
+    FramelessManagerPrivate::ensureWallpaperWatcher();
+    return DesktopWallpaperWatcher::instance()->aspectStyle();
 }
 
 bool Utils::isBlurBehindWindowSupported()
@@ -555,12 +618,12 @@ bool Utils::isBlurBehindWindowSupported()
         static const QString windowManager = getWindowManagerName();
         static const bool isDeepinV15 = (windowManager == FRAMELESSHELPER_STRING_LITERAL("Mutter(DeepinGala)"));
         if (isDeepinV15) {
-            static const xcb_atom_t atom = internAtom(ATOM_NET_WM_DEEPIN_BLUR_REGION_ROUNDED);
+            const xcb_atom_t atom = x11_atom(X11Atom::NET_WM_DEEPIN_BLUR_REGION_ROUNDED);
             return ((atom != XCB_NONE) && isSupportedByWindowManager(atom));
         }
         static const bool isKWin = (windowManager == FRAMELESSHELPER_STRING_LITERAL("KWin"));
         if (isKWin) {
-            static const xcb_atom_t atom = internAtom(ATOM_KDE_NET_WM_BLUR_BEHIND_REGION);
+            const xcb_atom_t atom = x11_atom(X11Atom::KDE_NET_WM_BLUR_BEHIND_REGION);
             return ((atom != XCB_NONE) && isSupportedByRootWindow(atom));
         }
 #endif
@@ -581,6 +644,18 @@ static inline void themeChangeNotificationCallback()
 
 void Utils::registerThemeChangeNotification()
 {
+    DesktopPortalSettings * const portalSettings = DesktopPortalSettings::instance();
+    if (!portalSettings->isInitialized()) {
+        // Only load GTK if it turns out that the desktop portal can't tell us.
+        QObject::connect(portalSettings, &DesktopPortalSettings::initialized, portalSettings, [](){
+            registerThemeChangeNotification();
+        });
+        return;
+    }
+    // FramelessManager listens to the desktop portal directly, no need to load GTK.
+    if (portalSettings->isAvailable()) {
+        return;
+    }
     GtkSettings * const settings = gtk_settings_get_default();
     Q_ASSERT(settings);
     if (!settings) {
@@ -602,7 +677,8 @@ xcb_atom_t Utils::internAtom(const char *name)
     if (!name || (*name == '\0')) {
         return XCB_NONE;
     }
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return XCB_NONE;
@@ -617,20 +693,56 @@ xcb_atom_t Utils::internAtom(const char *name)
     return atom;
 }
 
+xcb_atom_t Utils::x11_atom(const X11Atom atom)
+{
+    static constexpr const auto kAtomCount = std::size(kX11AtomNames);
+    using AtomTable = std::array<xcb_atom_t, kAtomCount>;
+    // Interning the atoms one by one costs a full round trip to the X server for each
+    // of them, which is quite noticeable on remote displays. So we send all the requests
+    // at once and only then collect the replies, to pay for a single round trip.
+    static const auto atoms = []() -> AtomTable {
+        AtomTable result = {};
+        result.fill(XCB_NONE);
+        const X11Context context = x11Context();
+        xcb_connection_t * const connection = context.connection;
+        Q_ASSERT(connection);
+        if (!connection) {
+            return result;
+        }
+        std::array<xcb_intern_atom_cookie_t, kAtomCount> cookies = {};
+        for (std::size_t index = 0; index != kAtomCount; ++index) {
+            const char * const name = kX11AtomNames[index];
+            cookies.at(index) = xcb_intern_atom(connection, false, qstrlen(name), name);
+        }
+        for (std::size_t index = 0; index != kAtomCount; ++index) {
+            xcb_intern_atom_reply_t * const reply = xcb_intern_atom_reply(connection, cookies.at(index), nullptr);
+            if (!reply) {
+                WARNING << "Failed to intern the atom of" << kX11AtomNames[index];
+                continue;
+            }
+            result.at(index) = reply->atom;
+            std::free(reply);
+        }
+        return result;
+    }();
+    return atoms.at(static_cast<int>(atom));
+}
+
 QString Utils::getWindowManagerName()
 {
     static const auto result = []() -> QString {
-        xcb_connection_t * const connection = x11_connection();
+        const X11Context context = x11Context();
+        xcb_connection_t * const connection = context.connection;
         Q_ASSERT(connection);
         if (!connection) {
             return {};
         }
-        const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
+        const quint32 rootWindow = context.rootWindow;
         Q_ASSERT(rootWindow);
         if (!rootWindow) {
             return {};
         }
-        static const xcb_atom_t wmCheckAtom = internAtom(ATOM_NET_SUPPORTING_WM_CHECK);
+        const xcb_atom_t wmCheckAtom = x11_atom(X11Atom::NET_SUPPORTING_WM_CHECK);
         if (wmCheckAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of _NET_SUPPORTING_WM_CHECK.";
             return {};
@@ -649,12 +761,12 @@ QString Utils::getWindowManagerName()
             std::free(reply);
             return {};
         }
-        static const xcb_atom_t wmNameAtom = internAtom(ATOM_NET_WM_NAME);
+        const xcb_atom_t wmNameAtom = x11_atom(X11Atom::NET_WM_NAME);
         if (wmNameAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of _NET_WM_NAME.";
             return {};
         }
-        static const xcb_atom_t strAtom = internAtom(ATOM_UTF8_STRING);
+        const xcb_atom_t strAtom = x11_atom(X11Atom::UTF8_STRING);
         if (strAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of UTF8_STRING.";
             return {};
@@ -687,19 +799,20 @@ void Utils::openSystemMenu(const WId windowId, const QPoint &globalPos)
         return;
     }
 
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return;
     }
 
-    const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
+    const quint32 rootWindow = context.rootWindow;
     Q_ASSERT(rootWindow);
     if (!rootWindow) {
         return;
     }
 
-    static const xcb_atom_t atom = internAtom(ATOM_GTK_SHOW_WINDOW_MENU);
+    const xcb_atom_t atom = x11_atom(X11Atom::GTK_SHOW_WINDOW_MENU);
     if ((atom == XCB_NONE) || !isSupportedByWindowManager(atom)) {
         WARNING << "Current window manager doesn't support showing window menu.";
         return;
@@ -727,7 +840,8 @@ QByteArray Utils::getWindowProperty(const WId windowId, const xcb_atom_t prop, c
     if (!windowId || (prop == XCB_NONE) || (type == XCB_NONE)) {
         return {};
     }
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return {};
@@ -753,7 +867,8 @@ void Utils::setWindowProperty(const WId windowId, const xcb_atom_t prop, const x
     if (!windowId || (prop == XCB_NONE) || (type == XCB_NONE)) {
         return;
     }
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return;
@@ -769,7 +884,8 @@ void Utils::clearWindowProperty(const WId windowId, const xcb_atom_t prop)
     if (!windowId || (prop == XCB_NONE)) {
         return;
     }
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return;
@@ -789,17 +905,18 @@ bool Utils::isSupportedByWindowManager(const xcb_atom_t atom)
     using result_type = QVector<xcb_atom_t>;
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     static const auto netWmAtoms = []() -> result_type {
-        xcb_connection_t * const connection = x11_connection();
+        const X11Context context = x11Context();
+        xcb_connection_t * const connection = context.connection;
         Q_ASSERT(connection);
         if (!connection) {
             return {};
         }
-        const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
+        const quint32 rootWindow = context.rootWindow;
         Q_ASSERT(rootWindow);
         if (!rootWindow) {
             return {};
         }
-        static const xcb_atom_t netSupportedAtom = internAtom(ATOM_NET_SUPPORTED);
+        const xcb_atom_t netSupportedAtom = x11_atom(X11Atom::NET_SUPPORTED);
         if (netSupportedAtom == XCB_NONE) {
             WARNING << "Failed to retrieve the atom of _NET_SUPPORTED.";
             return {};
@@ -842,12 +959,13 @@ bool Utils::isSupportedByRootWindow(const xcb_atom_t atom)
     using result_type = QVector<xcb_atom_t>;
 #endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
     static const auto rootWindowProperties = []() -> result_type {
-        xcb_connection_t * const connection = x11_connection();
+        const X11Context context = x11Context();
+        xcb_connection_t * const connection = context.connection;
         Q_ASSERT(connection);
         if (!connection) {
             return {};
         }
-        const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
+        const quint32 rootWindow = context.rootWindow;
         Q_ASSERT(rootWindow);
         if (!rootWindow) {
             return {};
@@ -874,14 +992,14 @@ bool Utils::tryHideSystemTitleBar(const WId windowId, const bool hide)
     if (!windowId) {
         return false;
     }
-    static const xcb_atom_t deepinNoTitleBarAtom = internAtom(ATOM_DEEPIN_NO_TITLEBAR);
+    const xcb_atom_t deepinNoTitleBarAtom = x11_atom(X11Atom::DEEPIN_NO_TITLEBAR);
     if ((deepinNoTitleBarAtom == XCB_NONE) || !isSupportedByWindowManager(deepinNoTitleBarAtom)) {
         WARNING << "Current window manager doesn't support hiding title bar natively.";
         return false;
     }
     const quint32 value = hide;
     setWindowProperty(windowId, deepinNoTitleBarAtom, XCB_ATOM_CARDINAL, &value, 1, sizeof(quint32) * 8);
-    static const xcb_atom_t deepinForceDecorateAtom = internAtom(ATOM_DEEPIN_FORCE_DECORATE);
+    const xcb_atom_t deepinForceDecorateAtom = x11_atom(X11Atom::DEEPIN_FORCE_DECORATE);
     if ((deepinForceDecorateAtom == XCB_NONE) || !isSupportedByWindowManager(deepinForceDecorateAtom)) {
         return true;
     }
@@ -900,18 +1018,19 @@ void Utils::sendMoveResizeMessage(const WId windowId, const uint32_t action, con
         return;
     }
 
-    xcb_connection_t * const connection = x11_connection();
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
     Q_ASSERT(connection);
     if (!connection) {
         return;
     }
-    const quint32 rootWindow = x11_appRootWindow(x11_appScreen());
+    const quint32 rootWindow = context.rootWindow;
     Q_ASSERT(rootWindow);
     if (!rootWindow) {
         return;
     }
 
-    static const xcb_atom_t atom = internAtom(ATOM_NET_WM_MOVERESIZE);
+    const xcb_atom_t atom = x11_atom(X11Atom::NET_WM_MOVERESIZE);
     if ((atom == XCB_NONE) || !isSupportedByWindowManager(atom)) {
         WARNING << "Current window manager doesn't support move resize operation.";
         return;
@@ -946,7 +1065,7 @@ void Utils::sendMoveResizeMessage(const WId windowId, const uint32_t action, con
 
 bool Utils::isCustomDecorationSupported()
 {
-    static const xcb_atom_t atom = internAtom(ATOM_DEEPIN_NO_TITLEBAR);
+    const xcb_atom_t atom = x11_atom(X11Atom::DEEPIN_NO_TITLEBAR);
     return ((atom != XCB_NONE) && isSupportedByWindowManager(atom));
 }
 
@@ -987,4 +1106,54 @@ bool Utils::setPlatformPropertiesForWindow(QWindow *window, const QVariantHash &
     return true;
 }
 
+void Utils::setWindowShadowMargins(const WId windowId, const QSize &size, const QMargins &margins, const int resizeBorderThickness)
+{
+    Q_ASSERT(windowId);
+    if (!windowId) {
+        return;
+    }
+    const X11Context context = x11Context();
+    xcb_connection_t * const connection = context.connection;
+    Q_ASSERT(connection);
+    if (!connection) {
+        return;
+    }
+    // Tell the window manager which part of the window is the shadow, so that it
+    // won't take it into account when snapping, tiling or placing the window.
+    const xcb_atom_t atom = x11_atom(X11Atom::GTK_FRAME_EXTENTS);
+    if (atom != XCB_NONE) {
+        if (margins.isNull()) {
+            clearWindowProperty(windowId, atom);
+        } else {
+            const std::array<quint32, 4> extents = { quint32(margins.left()),
+                quint32(margins.right()), quint32(margins.top()), quint32(margins.bottom()) };
+            setWindowProperty(windowId, atom, XCB_ATOM_CARDINAL, extents.data(), extents.size(), sizeof(quint32) * 8);
+        }
+    }
+    // And let the mouse events fall through the shadow to whatever is below it.
+    if (margins.isNull() || size.isEmpty()) {
+        if (API_AVAILABLE(libxcbshape, xcb_shape_mask)) {
+            // Passing no bitmap resets the input region to cover the whole window again.
+            API_CALL_FUNCTION2(libxcbshape, xcb_shape_mask, xcb_shape_mask_ptr, connection,
+                kXcbShapeSoSet, kXcbShapeSkInput, windowId, 0, 0, XCB_NONE);
+        }
+    } else {
+        if (!API_AVAILABLE(libxcbshape, xcb_shape_rectangles)) {
+            WARNING << "The XCB shape extension is not available, the window shadow will not be input transparent.";
+            xcb_flush(connection);
+            return;
+        }
+        // The resize area straddles the edge of the visible window, keep the half of it
+        // which lies in the shadow clickable too, otherwise only the inner half would be left.
+        const QRect bodyRect = QRect(QPoint(0, 0), size).marginsRemoved(margins);
+        const QRect inputRect = bodyRect.adjusted(-resizeBorderThickness, -resizeBorderThickness,
+            resizeBorderThickness, resizeBorderThickness).intersected(QRect(QPoint(0, 0), size));
+        const xcb_rectangle_t rect = { int16_t(inputRect.x()), int16_t(inputRect.y()),
+            uint16_t(qMax(0, inputRect.width())), uint16_t(qMax(0, inputRect.height())) };
+        API_CALL_FUNCTION2(libxcbshape, xcb_shape_rectangles, xcb_shape_rectangles_ptr, connection,
+            kXcbShapeSoSet, kXcbShapeSkInput, kXcbClipOrderingUnsorted, windowId, 0, 0, 1, &rect);
+    }
+    xcb_flush(connection);
+}
+
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "wallpapersource.h"
+#include "micamaterial.h"
+#include <QtCore/qmutex.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+using namespace Global;
+
+class ImageWallpaperSourcePrivate
+{
+public:
+    QImage image = {};
+    WallpaperAspectStyle aspectStyle = WallpaperAspectStyle::Fill;
+    // The pixels come from setImageData() and belong to the caller.
+    bool borrowed = false;
+    mutable QMutex mutex{};
+};
+
+WallpaperSource::WallpaperSource(QObject *parent) : QObject(parent)
+{
+}
+
+WallpaperSource::~WallpaperSource()
+{
+    // Subclasses are expected to do this in their own destructor already, by now
+    // their data is gone, but it's still better than leaving a dangling pointer.
+    if (MicaMaterial::wallpaperSource() == this) {
+        MicaMaterial::setWallpaperSource(nullptr);
+    }
+}
+
+WallpaperAspectStyle WallpaperSource::aspectStyle() const
+{
+    return WallpaperAspectStyle::Fill;
+}
+
+ImageWallpaperSource::ImageWallpaperSource(QObject *parent)
+    : WallpaperSource(parent), d_ptr(new ImageWallpaperSourcePrivate)
+{
+}
+
+ImageWallpaperSource::~ImageWallpaperSource()
+{
+    // Unregister while our data is still alive, this also waits for
+    // the image() call the wallpaper thread may be running right now.
+    if (MicaMaterial::wallpaperSource() == this) {
+        MicaMaterial::setWallpaperSource(nullptr);
+    }
+}
+
+[[nodiscard]] static inline QImage shrinkImage(const QImage &image, const QSize &maximumSize)
+{
+    if (image.isNull() || maximumSize.isEmpty()) {
+        return image;
+    }
+    if ((image.width() > maximumSize.width()) || (image.height() > maximumSize.height())) {
+        return image.scaled(maximumSize, Qt::KeepAspectRatio, Qt::FastTransformation);
+    }
+    return image;
+}
+
+QImage ImageWallpaperSource::image(const QSize &maximumSize)
+{
+    Q_D(ImageWallpaperSource);
+    QImage image = {};
+    {
+        const QMutexLocker locker(&d->mutex);
+        if (!d->borrowed) {
+            image = d->image;
+        } else if (!d->image.isNull()) {
+            // The caller may free the buffer as soon as another image is set, which
+            // needs the lock, but the result is blurred long after we return.
+            image = shrinkImage(d->image, maximumSize);
+            if (image.constBits() == d->image.constBits()) {
+                image = image.copy();
+            }
+            return image;
+        }
+    }
+    return shrinkImage(image, maximumSize);
+}
+
+WallpaperAspectStyle ImageWallpaperSource::aspectStyle() const
+{
+    Q_D(const ImageWallpaperSource);
+    const QMutexLocker locker(&d->mutex);
+    return d->aspectStyle;
+}
+
+void ImageWallpaperSource::setImage(const QImage &value)
+{
+    Q_D(ImageWallpaperSource);
+    {
+        const QMutexLocker locker(&d->mutex);
+        d->image = value;
+        d->borrowed = false;
+    }
+    Q_EMIT changed();
+}
+
+void ImageWallpaperSource::setImageData(const uchar *data, const QSize &size, const qsizetype bytesPerLine, const QImage::Format format)
+{
+    Q_ASSERT(data);
+    Q_ASSERT(!size.isEmpty());
+    if (!data || size.isEmpty()) {
+        return;
+    }
+    // The const constructor of QImage never writes to or copies the buffer, unless
+    // someone tries to modify the image, which we never do.
+    Q_D(ImageWallpaperSource);
+    {
+        const QMutexLocker locker(&d->mutex);
+        d->image = QImage(data, size.width(), size.height(), bytesPerLine, format);
+        d->borrowed = true;
+    }
+    Q_EMIT changed();
+}
+
+void ImageWallpaperSource::setAspectStyle(const WallpaperAspectStyle value)
+{
+    Q_D(ImageWallpaperSource);
+    {
+        const QMutexLocker locker(&d->mutex);
+        if (d->aspectStyle == value) {
+            return;
+        }
+        d->aspectStyle = value;
+    }
+    Q_EMIT changed();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
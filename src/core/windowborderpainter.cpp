@@ -26,6 +26,7 @@
 #include "windowborderpainter_p.h"
 #include "utils.h"
 #include "framelessmanager.h"
+#include "framelessconfig_p.h"
 #ifdef Q_OS_WINDOWS
 #  include "winverhelper_p.h"
 #endif
@@ -154,7 +155,13 @@ void WindowBorderPainterPrivate::paint(QPainter *painter, const QSize &size, con
     }());
     pen.setWidth(m_thickness.value_or(getNativeBorderThickness()));
     painter->setPen(pen);
-    painter->drawLines(lines);
+    // Follow the window shape if the whole window is outlined.
+    if ((lines.size() == 4) && FramelessConfig::instance()->isSet(Option::WindowUseRoundCorners)) {
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRoundedRect(QRectF(leftTop, rightBottom), kDefaultWindowCornerRadius, kDefaultWindowCornerRadius);
+    } else {
+        painter->drawLines(lines);
+    }
     painter->restore();
 }
 
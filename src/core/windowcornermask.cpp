@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "windowcornermask_p.h"
+#include "tracing_p.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qregion.h>
+#include <array>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcWindowCornerMask, "wangwenx190.framelesshelper.core.windowcornermask")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcWindowCornerMask)
+#  define DEBUG qCDebug(lcWindowCornerMask)
+#  define WARNING qCWarning(lcWindowCornerMask)
+#  define CRITICAL qCCritical(lcWindowCornerMask)
+#endif
+
+using namespace Global;
+
+[[maybe_unused]] static constexpr const QImage::Format kDefaultImageFormat = QImage::Format_ARGB32_Premultiplied;
+// One for each screen scale factor in use is usually all we need.
+static constexpr const int kMaximumCornerMaskCount = 4;
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+using RectList = QList<QRect>;
+#else
+using RectList = QVector<QRect>;
+#endif
+
+struct CornerMask
+{
+    int radius = 0;
+    qreal devicePixelRatio = 1.0;
+    // Top left, top right, bottom left and bottom right. Opaque outside of the rounded corner.
+    std::array<QImage, 4> images = {};
+    // How far the shape starts from the window edge, for each row of the top left corner.
+    QList<int> insets = {};
+};
+
+struct CornerMaskData
+{
+    QMutex mutex{};
+    QList<CornerMask> masks = {}; // Most recently used first.
+};
+
+Q_GLOBAL_STATIC(CornerMaskData, g_cornerMaskData)
+
+[[nodiscard]] static inline CornerMask generateCornerMask(const int radius, const qreal devicePixelRatio)
+{
+    FRAMELESSHELPER_TRACE_SCOPE("corners", "generateCornerMask");
+    CornerMask mask = {};
+    mask.radius = radius;
+    mask.devicePixelRatio = devicePixelRatio;
+    const QSize pixelSize = {qCeil(qreal(radius) * devicePixelRatio), qCeil(qreal(radius) * devicePixelRatio)};
+    QImage topLeft(pixelSize, kDefaultImageFormat);
+    topLeft.setDevicePixelRatio(devicePixelRatio);
+    topLeft.fill(kDefaultBlackColor);
+    QPainter painter(&topLeft);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(kDefaultBlackColor);
+    painter.drawEllipse(QRectF(0, 0, qreal(radius) * 2, qreal(radius) * 2));
+    painter.end();
+    const auto mirrored = [&topLeft, devicePixelRatio](const bool horizontal, const bool vertical) -> QImage {
+        QImage image = topLeft.mirrored(horizontal, vertical);
+        image.setDevicePixelRatio(devicePixelRatio);
+        return image;
+    };
+    mask.images = {topLeft, mirrored(true, false), mirrored(false, true), mirrored(true, true)};
+    // The shape can only follow whole logical pixels, so sample the middle of each row
+    // and treat the half covered pixels as inside, just like the antialiasing does.
+    mask.insets.reserve(radius);
+    for (int y = 0; y != radius; ++y) {
+        const int row = qMin(pixelSize.height() - 1, int((qreal(y) + 0.5) * devicePixelRatio));
+        const auto line = reinterpret_cast<const QRgb *>(topLeft.constScanLine(row));
+        int x = 0;
+        while ((x < pixelSize.width()) && (qAlpha(line[x]) >= 128)) {
+            ++x;
+        }
+        mask.insets.append(qMin(radius, qRound(qreal(x) / devicePixelRatio)));
+    }
+    return mask;
+}
+
+[[nodiscard]] static inline CornerMask cornerMask(const int radius, const qreal devicePixelRatio)
+{
+    const QMutexLocker locker(&g_cornerMaskData()->mutex);
+    auto &masks = g_cornerMaskData()->masks;
+    for (qsizetype index = 0; index != masks.size(); ++index) {
+        const CornerMask &mask = masks.at(index);
+        if ((mask.radius != radius) || !qFuzzyCompare(mask.devicePixelRatio, devicePixelRatio)) {
+            continue;
+        }
+        if (index > 0) {
+            masks.move(index, 0);
+        }
+        return masks.constFirst();
+    }
+    masks.prepend(generateCornerMask(radius, devicePixelRatio));
+    while (masks.size() > kMaximumCornerMaskCount) {
+        masks.removeLast();
+    }
+    return masks.constFirst();
+}
+
+QRegion WindowCornerMask::windowRegion(const QSize &size, const int radius, const qreal devicePixelRatio)
+{
+    Q_ASSERT(!size.isEmpty());
+    if (size.isEmpty()) {
+        return {};
+    }
+    const int width = size.width();
+    const int height = size.height();
+    if ((radius <= 0) || (width < (radius * 2)) || (height < (radius * 2))) {
+        return QRegion(0, 0, width, height);
+    }
+    const CornerMask mask = cornerMask(radius, devicePixelRatio);
+    // One band for each run of rows with the same inset, which is what QRegion
+    // would have merged them into anyway, so we can hand them over directly.
+    RectList top = {};
+    for (int y = 0; y != radius; ++y) {
+        const int inset = mask.insets.at(y);
+        if (!top.isEmpty() && (top.constLast().left() == inset)) {
+            top.last().setBottom(y);
+            continue;
+        }
+        top.append(QRect(inset, y, width - (inset * 2), 1));
+    }
+    RectList rects = {};
+    rects.reserve((top.size() * 2) + 1);
+    rects.append(top);
+    if (height > (radius * 2)) {
+        rects.append(QRect(0, radius, width, height - (radius * 2)));
+    }
+    for (auto it = top.crbegin(); it != top.crend(); ++it) {
+        rects.append(QRect(it->left(), height - it->bottom() - 1, it->width(), it->height()));
+    }
+    QRegion region = {};
+    region.setRects(rects.constData(), int(rects.size()));
+    return region;
+}
+
+void WindowCornerMask::eraseCorners(QPainter *painter, const QSize &size, const int radius)
+{
+    Q_ASSERT(painter);
+    Q_ASSERT(!size.isEmpty());
+    if (!painter || size.isEmpty() || (radius <= 0)) {
+        return;
+    }
+    const int width = size.width();
+    const int height = size.height();
+    if ((width < (radius * 2)) || (height < (radius * 2))) {
+        return;
+    }
+    const qreal dpr = (painter->device() ? painter->device()->devicePixelRatioF() : qreal(1));
+    const CornerMask mask = cornerMask(radius, dpr);
+    painter->save();
+    painter->setCompositionMode(QPainter::CompositionMode_DestinationOut);
+    painter->drawImage(QPoint(0, 0), mask.images.at(0));
+    painter->drawImage(QPoint(width - radius, 0), mask.images.at(1));
+    painter->drawImage(QPoint(0, height - radius), mask.images.at(2));
+    painter->drawImage(QPoint(width - radius, height - radius), mask.images.at(3));
+    painter->restore();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Core/private/windowcornermask_p.h"
@@ -0,0 +1,460 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include "windowshadowpainter.h"
+#include "windowshadowpainter_p.h"
+#include "micamaterial_p.h"
+#include "cachebudget_p.h"
+#include "tracing_p.h"
+#include "framethrottle_p.h"
+#include "framelesshelpercore_global_p.h"
+#include "utils.h"
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qwindow.h>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcWindowShadowPainter, "wangwenx190.framelesshelper.core.windowshadowpainter")
+
+#ifdef FRAMELESSHELPER_CORE_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcWindowShadowPainter)
+#  define DEBUG qCDebug(lcWindowShadowPainter)
+#  define WARNING qCWarning(lcWindowShadowPainter)
+#  define CRITICAL qCCritical(lcWindowShadowPainter)
+#endif
+
+using namespace Global;
+
+[[maybe_unused]] static constexpr const QImage::Format kDefaultImageFormat = QImage::Format_ARGB32_Premultiplied;
+[[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultShadowActiveColor = {0, 0, 0, 90};
+[[maybe_unused]] static Q_COLOR_CONSTEXPR const QColor kDefaultShadowInactiveColor = {0, 0, 0, 50};
+static constexpr const int kDefaultShadowRadius = 16;
+static constexpr const int kMaximumShadowRadius = 100;
+// Usually there are only two of them alive (one for the active windows and one for the
+// inactive ones), the rest are left over from DPI or color changes.
+static constexpr const int kMaximumShadowAtlasCount = 8;
+
+struct ShadowAtlasData
+{
+    QMutex mutex{};
+    QList<std::pair<WindowShadowPainterPrivate::AtlasKey, QImage>> atlases = {}; // Most recently used first.
+};
+
+Q_GLOBAL_STATIC(ShadowAtlasData, g_shadowAtlasData)
+
+[[nodiscard]] static inline qint64 shadowAtlasBytes_unlocked()
+{
+    qint64 bytes = 0;
+    for (auto &&atlas : std::as_const(g_shadowAtlasData()->atlases)) {
+        bytes += (qint64(atlas.second.bytesPerLine()) * qint64(atlas.second.height()));
+    }
+    return bytes;
+}
+
+static inline void trimShadowAtlases(const qint64 bytes)
+{
+    Q_UNUSED(bytes);
+    {
+        const QMutexLocker locker(&g_shadowAtlasData()->mutex);
+        if (g_shadowAtlasData()->atlases.isEmpty()) {
+            return;
+        }
+        // Cheap to build again, the painters will do so the next time they paint.
+        g_shadowAtlasData()->atlases.clear();
+    }
+    CacheBudget::instance()->setUsage(CacheBudget::Cache::Shadows, 0);
+}
+
+WindowShadowPainterPrivate::WindowShadowPainterPrivate(WindowShadowPainter *q) : QObject(q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return;
+    }
+    q_ptr = q;
+    initialize();
+}
+
+WindowShadowPainterPrivate::~WindowShadowPainterPrivate() = default;
+
+WindowShadowPainterPrivate *WindowShadowPainterPrivate::get(WindowShadowPainter *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+const WindowShadowPainterPrivate *WindowShadowPainterPrivate::get(const WindowShadowPainter *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+QImage WindowShadowPainterPrivate::shadowAtlas(const AtlasKey &key)
+{
+    Q_ASSERT(key.radius > 0);
+    if (key.radius <= 0) {
+        return {};
+    }
+    {
+        const QMutexLocker locker(&g_shadowAtlasData()->mutex);
+        auto &atlases = g_shadowAtlasData()->atlases;
+        for (qsizetype index = 0; index != atlases.size(); ++index) {
+            if (atlases.at(index).first != key) {
+                continue;
+            }
+            if (index > 0) {
+                atlases.move(index, 0);
+            }
+            return atlases.constFirst().second;
+        }
+    }
+    FRAMELESSHELPER_TRACE_SCOPE("shadow", "buildShadowAtlas");
+    // The corners have to hold both the rounded corner and the blur around it. The straight
+    // part in the middle must be long enough that the blur of the corners can't reach
+    // the one pixel slice we stretch along the edges, otherwise it wouldn't be uniform.
+    const int extent = (key.radius + key.cornerRadius);
+    const int side = ((extent + key.radius) * 2 + 1);
+    QImage image(QSizeF(QSizeF(side, side) * key.devicePixelRatio).toSize(), kDefaultImageFormat);
+    image.setDevicePixelRatio(key.devicePixelRatio);
+    image.fill(kDefaultTransparentColor);
+    const QRectF shapeRect = {qreal(key.radius), qreal(key.radius),
+        qreal(side - (key.radius * 2)), qreal(side - (key.radius * 2))};
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor::fromRgba(key.color));
+    painter.drawRoundedRect(shapeRect, key.cornerRadius, key.cornerRadius);
+    painter.end();
+    QImage atlas = MicaMaterialPrivate::blurImage(image, (qreal(key.radius) * key.devicePixelRatio));
+    // The window is drawn on top of the shadow, but it may be translucent.
+    painter.begin(&atlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(kDefaultBlackColor);
+    painter.drawRoundedRect(shapeRect, key.cornerRadius, key.cornerRadius);
+    painter.end();
+    qint64 bytes = 0;
+    {
+        const QMutexLocker locker(&g_shadowAtlasData()->mutex);
+        auto &atlases = g_shadowAtlasData()->atlases;
+        atlases.prepend(std::make_pair(key, atlas));
+        while (atlases.size() > kMaximumShadowAtlasCount) {
+            atlases.removeLast();
+        }
+        bytes = shadowAtlasBytes_unlocked();
+    }
+    CacheBudget::instance()->setUsage(CacheBudget::Cache::Shadows, bytes);
+    return atlas;
+}
+
+void WindowShadowPainterPrivate::paint(QPainter *painter, const QSize &size, const bool active) const
+{
+    Q_ASSERT(painter);
+    Q_ASSERT(!size.isEmpty());
+    if (!painter || size.isEmpty() || (m_radius <= 0) || !isShadowVisible()) {
+        return;
+    }
+    // The corners take everything the blur of the rounded corners can reach, the shadow is
+    // only uniform along the edges past them. The slice we stretch is the column (or row) right
+    // after the corner, which is the middle one of the atlas.
+    const int cornerSize = (m_radius * 2 + m_cornerRadius);
+    const int width = size.width();
+    const int height = size.height();
+    if ((width < (cornerSize * 2)) || (height < (cornerSize * 2))) {
+        return;
+    }
+    const QColor color = (active ? m_activeColor : m_inactiveColor);
+    if (color.alpha() <= 0) {
+        return;
+    }
+    const qreal dpr = (painter->device() ? painter->device()->devicePixelRatioF() : qreal(1));
+    const QImage atlas = shadowAtlas({m_radius, m_cornerRadius, color.rgba(), dpr});
+    if (atlas.isNull()) {
+        return;
+    }
+    // Everything below is in the device pixels of the atlas.
+    const qreal full = atlas.width();
+    const qreal corner = (qreal(cornerSize) * dpr);
+    const qreal slice = corner;
+    // Only eight blits, no matter how large the window is. The edges are stretched from
+    // a slice which is uniform along them, so there's no need for smooth scaling.
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+    const qreal right = (width - cornerSize);
+    const qreal bottom = (height - cornerSize);
+    const qreal hlen = (width - (cornerSize * 2));
+    const qreal vlen = (height - (cornerSize * 2));
+    painter->drawImage(QRectF(0, 0, cornerSize, cornerSize), atlas, QRectF(0, 0, corner, corner));
+    painter->drawImage(QRectF(right, 0, cornerSize, cornerSize), atlas, QRectF(full - corner, 0, corner, corner));
+    painter->drawImage(QRectF(0, bottom, cornerSize, cornerSize), atlas, QRectF(0, full - corner, corner, corner));
+    painter->drawImage(QRectF(right, bottom, cornerSize, cornerSize), atlas, QRectF(full - corner, full - corner, corner, corner));
+    if (hlen > 0) {
+        painter->drawImage(QRectF(cornerSize, 0, hlen, cornerSize), atlas, QRectF(slice, 0, dpr, corner));
+        painter->drawImage(QRectF(cornerSize, bottom, hlen, cornerSize), atlas, QRectF(slice, full - corner, dpr, corner));
+    }
+    if (vlen > 0) {
+        painter->drawImage(QRectF(0, cornerSize, cornerSize, vlen), atlas, QRectF(0, slice, corner, dpr));
+        painter->drawImage(QRectF(right, cornerSize, cornerSize, vlen), atlas, QRectF(full - corner, slice, corner, dpr));
+    }
+    painter->restore();
+}
+
+bool WindowShadowPainterPrivate::isShadowVisible() const
+{
+    // Without a window we can't tell, the caller knows better when to paint then.
+    if (!m_window) {
+        return true;
+    }
+    return (m_window->windowState() == Qt::WindowNoState);
+}
+
+void WindowShadowPainterPrivate::scheduleWindowMarginsUpdate()
+{
+    if (m_windowMarginsThrottle) {
+        m_windowMarginsThrottle->schedule();
+    }
+}
+
+void WindowShadowPainterPrivate::updateWindowMargins()
+{
+    if (!m_window) {
+        return;
+    }
+    Q_Q(const WindowShadowPainter);
+    const QMargins margins = q->margins();
+    // Let the hit tests know where the visible part of the window starts.
+    m_window->setProperty(kWindowShadowMarginsProperty, (margins.isNull() ? QVariant() : QVariant::fromValue(margins)));
+#ifdef Q_OS_LINUX
+    if (!m_window->handle()) {
+        return;
+    }
+    const QMargins nativeMargins = {Utils::toNativePixels(m_window, margins.left()),
+        Utils::toNativePixels(m_window, margins.top()), Utils::toNativePixels(m_window, margins.right()),
+        Utils::toNativePixels(m_window, margins.bottom())};
+    Utils::setWindowShadowMargins(m_window->winId(), Utils::toNativePixels(m_window, m_window->size()),
+        nativeMargins, Utils::toNativePixels(m_window, kDefaultResizeBorderThickness));
+#endif // Q_OS_LINUX
+}
+
+bool WindowShadowPainterPrivate::eventFilter(QObject *object, QEvent *event)
+{
+    Q_ASSERT(object);
+    Q_ASSERT(event);
+    if (!object || !event) {
+        return false;
+    }
+    if (object == m_window) {
+        switch (event->type()) {
+        case QEvent::Resize:
+        case QEvent::PlatformSurface:
+        case QEvent::ScreenChangeInternal:
+            // The input region is in native pixels and doesn't follow the window size.
+            scheduleWindowMarginsUpdate();
+            break;
+        case QEvent::WindowStateChange: {
+            // The shadow comes and goes with the normal state, so do its margins.
+            Q_Q(WindowShadowPainter);
+            Q_EMIT q->marginsChanged();
+            Q_EMIT q->shouldRepaint();
+        } break;
+        default:
+            break;
+        }
+    }
+    return QObject::eventFilter(object, event);
+}
+
+void WindowShadowPainterPrivate::initialize()
+{
+    m_radius = kDefaultShadowRadius;
+    m_activeColor = kDefaultShadowActiveColor;
+    m_inactiveColor = kDefaultShadowInactiveColor;
+    static const bool trimmerRegistered = [](){
+        CacheBudget::instance()->setTrimmer(CacheBudget::Cache::Shadows, trimShadowAtlases);
+        return true;
+    }();
+    Q_UNUSED(trimmerRegistered);
+    Q_Q(WindowShadowPainter);
+    connect(q, &WindowShadowPainter::marginsChanged, this, &WindowShadowPainterPrivate::scheduleWindowMarginsUpdate);
+}
+
+WindowShadowPainter::WindowShadowPainter(QObject *parent)
+    : QObject(parent), d_ptr(new WindowShadowPainterPrivate(this))
+{
+}
+
+WindowShadowPainter::~WindowShadowPainter() = default;
+
+int WindowShadowPainter::radius() const
+{
+    Q_D(const WindowShadowPainter);
+    return d->m_radius;
+}
+
+int WindowShadowPainter::cornerRadius() const
+{
+    Q_D(const WindowShadowPainter);
+    return d->m_cornerRadius;
+}
+
+QColor WindowShadowPainter::activeColor() const
+{
+    Q_D(const WindowShadowPainter);
+    return d->m_activeColor;
+}
+
+QColor WindowShadowPainter::inactiveColor() const
+{
+    Q_D(const WindowShadowPainter);
+    return d->m_inactiveColor;
+}
+
+QMargins WindowShadowPainter::margins() const
+{
+    Q_D(const WindowShadowPainter);
+    if (!d->isShadowVisible()) {
+        return {};
+    }
+    return {d->m_radius, d->m_radius, d->m_radius, d->m_radius};
+}
+
+QWindow *WindowShadowPainter::window() const
+{
+    Q_D(const WindowShadowPainter);
+    return d->m_window;
+}
+
+void WindowShadowPainter::paint(QPainter *painter, const QSize &size, const bool active) const
+{
+    Q_D(const WindowShadowPainter);
+    d->paint(painter, size, active);
+}
+
+void WindowShadowPainter::setRadius(const int value)
+{
+    Q_ASSERT(value >= 0);
+    Q_ASSERT(value < kMaximumShadowRadius);
+    if ((value < 0) || (value >= kMaximumShadowRadius)) {
+        return;
+    }
+    if (radius() == value) {
+        return;
+    }
+    Q_D(WindowShadowPainter);
+    d->m_radius = value;
+    Q_EMIT radiusChanged();
+    Q_EMIT marginsChanged();
+    Q_EMIT shouldRepaint();
+}
+
+void WindowShadowPainter::setCornerRadius(const int value)
+{
+    Q_ASSERT(value >= 0);
+    if (value < 0) {
+        return;
+    }
+    if (cornerRadius() == value) {
+        return;
+    }
+    Q_D(WindowShadowPainter);
+    d->m_cornerRadius = value;
+    Q_EMIT cornerRadiusChanged();
+    Q_EMIT shouldRepaint();
+}
+
+void WindowShadowPainter::setActiveColor(const QColor &value)
+{
+    Q_ASSERT(value.isValid());
+    if (!value.isValid()) {
+        return;
+    }
+    if (activeColor() == value) {
+        return;
+    }
+    Q_D(WindowShadowPainter);
+    d->m_activeColor = value;
+    Q_EMIT activeColorChanged();
+    Q_EMIT shouldRepaint();
+}
+
+void WindowShadowPainter::setInactiveColor(const QColor &value)
+{
+    Q_ASSERT(value.isValid());
+    if (!value.isValid()) {
+        return;
+    }
+    if (inactiveColor() == value) {
+        return;
+    }
+    Q_D(WindowShadowPainter);
+    d->m_inactiveColor = value;
+    Q_EMIT inactiveColorChanged();
+    Q_EMIT shouldRepaint();
+}
+
+void WindowShadowPainter::setWindow(QWindow *value)
+{
+    Q_D(WindowShadowPainter);
+    if (d->m_window == value) {
+        return;
+    }
+    if (d->m_window) {
+        d->m_window->removeEventFilter(d);
+        d->m_window->setProperty(kWindowShadowMarginsProperty, {});
+#ifdef Q_OS_LINUX
+        if (d->m_window->handle()) {
+            Utils::setWindowShadowMargins(d->m_window->winId(), {}, {}, 0);
+        }
+#endif // Q_OS_LINUX
+    }
+    if (d->m_windowMarginsThrottle) {
+        d->m_windowMarginsThrottle->cancel();
+        delete d->m_windowMarginsThrottle;
+        d->m_windowMarginsThrottle = nullptr;
+    }
+    d->m_window = value;
+    if (d->m_window) {
+        d->m_window->installEventFilter(d);
+        d->m_windowMarginsThrottle = new FrameThrottle(d->m_window, [d](){ d->updateWindowMargins(); }, d);
+        d->updateWindowMargins();
+    }
+    Q_EMIT windowChanged();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
@@ -30,6 +30,8 @@
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/tracing_p.h>
+#include <FramelessHelper/Core/private/statistics_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
@@ -167,6 +169,7 @@ void FramelessQuickHelperPrivate::setTitleBarItem(QQuickItem *value)
 
 void FramelessQuickHelperPrivate::attach()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("helper", "FramelessQuickHelper::attach");
     Q_Q(FramelessQuickHelper);
     QQuickWindow * const window = q->window();
     Q_ASSERT(window);
@@ -234,6 +237,7 @@ void FramelessQuickHelperPrivate::attach()
         if (FramelessConfig::instance()->isSet(Option::EnableBlurBehindWindow)) {
             setBlurBehindWindowEnabled(true, {});
         }
+        FRAMELESSHELPER_TRACE_INSTANT("helper", "FramelessQuickHelper::ready");
         emitSignalForAllInstances("ready");
     });
 }
@@ -730,6 +734,7 @@ QRect FramelessQuickHelperPrivate::mapItemGeometryToScene(const QQuickItem * con
 
 bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlobal::SystemButtonType *button) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessQuickHelper::isInSystemButtons");
     Q_ASSERT(button);
     if (!button) {
         return false;
@@ -774,6 +779,8 @@ bool FramelessQuickHelperPrivate::isInSystemButtons(const QPoint &pos, QuickGlob
 
 bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessQuickHelper::isInTitleBarDraggableArea");
+    const StatisticsTimer statisticsTimer(StatisticsRecorder::Histogram::HitTest);
     const FramelessQuickHelperData *data = getWindowData();
     if (!data) {
         return false;
@@ -830,13 +837,15 @@ bool FramelessQuickHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) c
 
 bool FramelessQuickHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessQuickHelper::shouldIgnoreMouseEvents");
     Q_Q(const FramelessQuickHelper);
     const QQuickWindow * const window = q->window();
     if (!window) {
         return false;
     }
     const auto withinFrameBorder = [&pos, window]() -> bool {
-        if (pos.y() < kDefaultResizeBorderThickness) {
+        const QMargins margins = Utils::windowShadowMargins(window);
+        if (pos.y() < (margins.top() + kDefaultResizeBorderThickness)) {
             return true;
         }
 #ifdef Q_OS_WINDOWS
@@ -844,8 +853,8 @@ bool FramelessQuickHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) con
             return false;
         }
 #endif
-        return ((pos.x() < kDefaultResizeBorderThickness)
-                || (pos.x() >= (window->width() - kDefaultResizeBorderThickness)));
+        return ((pos.x() < (margins.left() + kDefaultResizeBorderThickness))
+                || (pos.x() >= (window->width() - margins.right() - kDefaultResizeBorderThickness)));
     }();
     return ((window->visibility() == QQuickWindow::Windowed) && withinFrameBorder);
 }
@@ -29,6 +29,7 @@
 #include "quickmicamaterial.h"
 #include "quickimageitem.h"
 #include "quickwindowborder.h"
+#include "quickcompacttitlebar.h"
 #ifndef FRAMELESSHELPER_QUICK_NO_PRIVATE
 #  include "framelessquickwindow_p.h"
 #  if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -98,6 +99,7 @@ void FramelessHelper::Quick::registerTypes(QQmlEngine *engine)
     qmlRegisterType<QuickMicaMaterial>(QUICK_URI_EXPAND("MicaMaterial"));
     qmlRegisterType<QuickImageItem>(QUICK_URI_EXPAND("ImageItem"));
     qmlRegisterType<QuickWindowBorder>(QUICK_URI_EXPAND("WindowBorder"));
+    qmlRegisterType<QuickCompactTitleBar>(QUICK_URI_EXPAND("CompactTitleBar"));
 
 #ifdef FRAMELESSHELPER_QUICK_NO_PRIVATE
     qmlRegisterTypeNotAvailable(QUICK_URI_EXPAND("FramelessWindow"),
@@ -0,0 +1,955 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "quickcompacttitlebar.h"
+#include "quickcompacttitlebar_p.h"
+#include "quickchromepalette.h"
+#include "framelessquickhelper.h"
+#ifndef FRAMELESSHELPER_QUICK_NO_PRIVATE
+#  include "framelessquickwindow_p.h"
+#endif // FRAMELESSHELPER_QUICK_NO_PRIVATE
+#include <FramelessHelper/Core/utils.h>
+#include <FramelessHelper/Core/private/framelessmanager_p.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtGui/qevent.h>
+#include <QtGui/qicon.h>
+#include <QtGui/qpainter.h>
+#include <QtGui/qpixmap.h>
+#include <QtGui/qtextlayout.h>
+#include <QtGui/qguiapplication.h>
+#include <QtQuick/qquickwindow.h>
+#include <QtQuick/qsgsimplerectnode.h>
+#include <QtQuick/qsgsimpletexturenode.h>
+#include <cmath>
+#include <memory>
+
+FRAMELESSHELPER_BEGIN_NAMESPACE
+
+[[maybe_unused]] static Q_LOGGING_CATEGORY(lcQuickCompactTitleBar, "wangwenx190.framelesshelper.quick.quickcompacttitlebar")
+
+#ifdef FRAMELESSHELPER_QUICK_NO_DEBUG_OUTPUT
+#  define INFO QT_NO_QDEBUG_MACRO()
+#  define DEBUG QT_NO_QDEBUG_MACRO()
+#  define WARNING QT_NO_QDEBUG_MACRO()
+#  define CRITICAL QT_NO_QDEBUG_MACRO()
+#else
+#  define INFO qCInfo(lcQuickCompactTitleBar)
+#  define DEBUG qCDebug(lcQuickCompactTitleBar)
+#  define WARNING qCWarning(lcQuickCompactTitleBar)
+#  define CRITICAL qCCritical(lcQuickCompactTitleBar)
+#endif
+
+using namespace Global;
+
+FRAMELESSHELPER_STRING_CONSTANT2(QrcPrefix, "qrc:")
+FRAMELESSHELPER_STRING_CONSTANT2(FileSystemPrefix, ":")
+
+[[maybe_unused]] static constexpr const QImage::Format kDefaultImageFormat = QImage::Format_ARGB32_Premultiplied;
+
+// The root node owns the textures, so that they are always destroyed on the render thread,
+// together with the rest of the scene graph.
+class CompactTitleBarNode : public QSGSimpleRectNode
+{
+public:
+    struct Texture
+    {
+        std::unique_ptr<QSGTexture> texture = nullptr;
+        qint64 imageKey = 0;
+    };
+
+    CompactTitleBarNode() = default;
+    ~CompactTitleBarNode() override = default;
+
+    Texture title = {};
+    Texture windowIcon = {};
+    std::array<Texture, 3> buttons = {};
+};
+
+[[nodiscard]] static inline quint64 mixKey(const quint64 seed, const quint64 value)
+{
+    // FNV-1a style mixing, we only need it to detect changes, not to be cryptographically strong.
+    return ((seed ^ value) * quint64(0x100000001b3));
+}
+
+[[nodiscard]] static inline quint64 dprKey(const qreal dpr)
+{
+    return quint64(qRound(dpr * qreal(100)));
+}
+
+[[nodiscard]] static inline QSGTexture *uploadImage(QQuickWindow *window, CompactTitleBarNode::Texture &texture, const QImage &image)
+{
+    Q_ASSERT(window);
+    if (!window || image.isNull()) {
+        return nullptr;
+    }
+    // Only upload again if the image has really changed since the last frame.
+    if (!texture.texture || (texture.imageKey != image.cacheKey())) {
+        texture.texture.reset(window->createTextureFromImage(image));
+        texture.imageKey = image.cacheKey();
+    }
+    return texture.texture.get();
+}
+
+static inline void appendTextureNode(QSGNode *parent, QSGTexture *texture, const QRectF &rect)
+{
+    Q_ASSERT(parent);
+    if (!parent || !texture || rect.isEmpty()) {
+        return;
+    }
+    const auto node = new QSGSimpleTextureNode;
+    node->setTexture(texture);
+    node->setRect(rect);
+    node->setFiltering(QSGTexture::Linear);
+    parent->appendChildNode(node);
+}
+
+[[nodiscard]] static inline QSizeF imageLogicalSize(const QImage &image)
+{
+    if (image.isNull()) {
+        return {};
+    }
+    return (QSizeF(image.size()) / image.devicePixelRatio());
+}
+
+[[nodiscard]] static inline QImage iconSourceToImage(const QVariant &source, const QSize &size)
+{
+    if (!source.isValid() || source.isNull()) {
+        return {};
+    }
+    switch (source.userType()) {
+    case QMetaType::QIcon:
+        return qvariant_cast<QIcon>(source).pixmap(size).toImage();
+    case QMetaType::QImage:
+        return qvariant_cast<QImage>(source);
+    case QMetaType::QPixmap:
+        return qvariant_cast<QPixmap>(source).toImage();
+    case QMetaType::QUrl: {
+        const QUrl url = source.toUrl();
+        if (url.isLocalFile()) {
+            return QImage(url.toLocalFile());
+        }
+        QString path = url.toString();
+        if (path.startsWith(kQrcPrefix, Qt::CaseInsensitive)) {
+            path = (kFileSystemPrefix + path.mid(kQrcPrefix.size()));
+        }
+        return QImage(path);
+    }
+    case QMetaType::QString:
+        return QImage(source.toString());
+    default:
+        WARNING << "Unsupported type:" << source.typeName();
+        break;
+    }
+    return {};
+}
+
+QuickCompactTitleBarPrivate::QuickCompactTitleBarPrivate(QuickCompactTitleBar *q) : QObject(q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return;
+    }
+    q_ptr = q;
+    initialize();
+}
+
+QuickCompactTitleBarPrivate::~QuickCompactTitleBarPrivate() = default;
+
+QuickCompactTitleBarPrivate *QuickCompactTitleBarPrivate::get(QuickCompactTitleBar *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+const QuickCompactTitleBarPrivate *QuickCompactTitleBarPrivate::get(const QuickCompactTitleBar *q)
+{
+    Q_ASSERT(q);
+    if (!q) {
+        return nullptr;
+    }
+    return q->d_func();
+}
+
+QFont QuickCompactTitleBarPrivate::titleFont() const
+{
+    if (m_titleFont.has_value()) {
+        return m_titleFont.value();
+    }
+    QFont font = QGuiApplication::font();
+    font.setPointSize(kDefaultTitleBarFontPointSize);
+    return font;
+}
+
+bool QuickCompactTitleBarPrivate::isActive() const
+{
+    return (m_window ? m_window->isActive() : false);
+}
+
+qreal QuickCompactTitleBarPrivate::devicePixelRatio() const
+{
+    return (m_window ? m_window->effectiveDevicePixelRatio() : qApp->devicePixelRatio());
+}
+
+QuickGlobal::SystemButtonType QuickCompactTitleBarPrivate::buttonType(const int index) const
+{
+    switch (index) {
+    case 0:
+        return QuickGlobal::SystemButtonType::Minimize;
+    case 1:
+        if (m_window && (m_window->visibility() == QQuickWindow::Maximized)) {
+            return QuickGlobal::SystemButtonType::Restore;
+        }
+        return QuickGlobal::SystemButtonType::Maximize;
+    case 2:
+        return QuickGlobal::SystemButtonType::Close;
+    default:
+        break;
+    }
+    return QuickGlobal::SystemButtonType::Unknown;
+}
+
+QRectF QuickCompactTitleBarPrivate::buttonRect(const int index) const
+{
+    if ((index < 0) || (index >= kButtonCount)) {
+        return {};
+    }
+    Q_Q(const QuickCompactTitleBar);
+    const QSizeF size = kDefaultSystemButtonSize;
+    return {QPointF(q->width() - (qreal(kButtonCount - index) * size.width()), qreal(0)), size};
+}
+
+int QuickCompactTitleBarPrivate::buttonAt(const QPointF &pos) const
+{
+    for (int index = 0; index != kButtonCount; ++index) {
+        if (buttonRect(index).contains(pos)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+QRectF QuickCompactTitleBarPrivate::windowIconRect() const
+{
+    Q_Q(const QuickCompactTitleBar);
+    const qreal y = ((q->height() - m_windowIconSize.height()) / qreal(2));
+#ifdef Q_OS_MACOS
+    // The icon sits right before the title on macOS.
+    const qreal x = (titleRect().left() - kDefaultTitleBarContentsMargin - m_windowIconSize.width());
+#else // !Q_OS_MACOS
+    const qreal x = kDefaultTitleBarContentsMargin;
+#endif // Q_OS_MACOS
+    return {QPointF(x, y), m_windowIconSize};
+}
+
+bool QuickCompactTitleBarPrivate::windowIconVisible_real() const
+{
+    if (!m_windowIconVisible || m_windowIconSize.isEmpty()) {
+        return false;
+    }
+    if (m_windowIcon.isValid() && !m_windowIcon.isNull()) {
+        return true;
+    }
+    return (m_window && !m_window->icon().isNull());
+}
+
+std::pair<qreal, qreal> QuickCompactTitleBarPrivate::titleBounds() const
+{
+    Q_Q(const QuickCompactTitleBar);
+#ifdef Q_OS_MACOS
+    const qreal left = kDefaultTitleBarContentsMargin;
+#else // !Q_OS_MACOS
+    const qreal left = (windowIconVisible_real() ? (windowIconRect().right() + kDefaultTitleBarContentsMargin) : qreal(kDefaultTitleBarContentsMargin));
+#endif // Q_OS_MACOS
+    const qreal right = (q->width() - (qreal(kButtonCount) * kDefaultSystemButtonSize.width()) - kDefaultTitleBarContentsMargin);
+    return std::make_pair(left, qMax(left, right));
+}
+
+QRectF QuickCompactTitleBarPrivate::titleRect() const
+{
+    Q_Q(const QuickCompactTitleBar);
+    const QSizeF size = (m_titleLayout.has_value() ? m_titleLayout.value().size : QSizeF());
+    const auto [left, right] = titleBounds();
+    const qreal y = ((q->height() - size.height()) / qreal(2));
+    qreal x = left;
+    if (m_labelAlignment & Qt::AlignRight) {
+        x = (right - size.width());
+    } else if (m_labelAlignment & Qt::AlignHCenter) {
+        x = ((q->width() - size.width()) / qreal(2));
+    }
+    return {QPointF(x, y), size};
+}
+
+bool QuickCompactTitleBarPrivate::isInTitleBarIconArea(const QPointF &pos) const
+{
+    if (!windowIconVisible_real()) {
+        return false;
+    }
+    return windowIconRect().contains(pos);
+}
+
+void QuickCompactTitleBarPrivate::rasterize()
+{
+    const qreal dpr = devicePixelRatio();
+    rasterizeTitle(dpr);
+    rasterizeWindowIcon(dpr);
+    rasterizeButtons(dpr);
+}
+
+void QuickCompactTitleBarPrivate::rasterizeTitle(const qreal dpr)
+{
+    const QString text = (m_window ? m_window->title() : QString());
+    const QFont font = titleFont();
+    const auto [left, right] = titleBounds();
+    const qreal availableWidth = (right - left);
+    // Shaping is the expensive part, only do it again if the text, the font or the room we have changed.
+    if (!m_titleLayout.has_value() || (m_titleLayout.value().text != text)
+        || (m_titleLayout.value().font != font) || !qFuzzyCompare(m_titleLayout.value().availableWidth, availableWidth)) {
+        TitleLayout titleLayout = {};
+        titleLayout.text = text;
+        titleLayout.font = font;
+        titleLayout.availableWidth = availableWidth;
+        titleLayout.serial = (m_titleLayout.has_value() ? (m_titleLayout.value().serial + 1) : 1);
+        const QFontMetricsF fontMetrics(font);
+        QTextLayout textLayout(fontMetrics.elidedText(text, Qt::ElideRight, availableWidth), font);
+        textLayout.beginLayout();
+        QTextLine line = textLayout.createLine();
+        if (line.isValid()) {
+            line.setPosition(QPointF(0, 0));
+        }
+        textLayout.endLayout();
+        if (line.isValid()) {
+            titleLayout.glyphRuns = textLayout.glyphRuns();
+            titleLayout.size = QSizeF(line.naturalTextWidth(), line.height());
+        }
+        m_titleLayout = titleLayout;
+    }
+    const QColor color = (isActive() ?
+        m_chromePalette->titleBarActiveForegroundColor() :
+        m_chromePalette->titleBarInactiveForegroundColor());
+    const quint64 key = mixKey(mixKey(m_titleLayout.value().serial, color.rgba()), dprKey(dpr));
+    if (m_titleImage.sourceKey == qint64(key)) {
+        return;
+    }
+    m_titleImage.sourceKey = qint64(key);
+    const QSizeF size = m_titleLayout.value().size;
+    if (size.isEmpty() || m_titleLayout.value().glyphRuns.isEmpty()) {
+        m_titleImage.image = {};
+        return;
+    }
+    QImage image(QSizeF(size * dpr).toSize() + QSize(1, 1), kDefaultImageFormat);
+    image.setDevicePixelRatio(dpr);
+    image.fill(kDefaultTransparentColor);
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing);
+    painter.setPen(color);
+    // The glyph runs are already shaped and positioned, no text layout happens here.
+    for (auto &&glyphRun : std::as_const(m_titleLayout.value().glyphRuns)) {
+        painter.drawGlyphRun(QPointF(0, 0), glyphRun);
+    }
+    painter.end();
+    m_titleImage.image = image;
+}
+
+void QuickCompactTitleBarPrivate::rasterizeWindowIcon(const qreal dpr)
+{
+    if (!windowIconVisible_real()) {
+        m_windowIconImage = {};
+        return;
+    }
+    const bool useWindowIcon = (!m_windowIcon.isValid() || m_windowIcon.isNull());
+    const quint64 sourceKey = (useWindowIcon ? quint64(m_window->icon().cacheKey()) : m_windowIconSerial);
+    const quint64 key = mixKey(mixKey(mixKey(sourceKey, quint64(useWindowIcon)),
+        mixKey(quint64(qRound(m_windowIconSize.width())), quint64(qRound(m_windowIconSize.height())))), dprKey(dpr));
+    if (!m_windowIconImage.image.isNull() && (m_windowIconImage.sourceKey == qint64(key))) {
+        return;
+    }
+    m_windowIconImage.sourceKey = qint64(key);
+    const QSize deviceSize = QSizeF(m_windowIconSize * dpr).toSize();
+    QImage image = iconSourceToImage((useWindowIcon ? QVariant(m_window->icon()) : m_windowIcon), deviceSize);
+    if (!image.isNull() && (image.size() != deviceSize)) {
+        image = image.scaled(deviceSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    image.setDevicePixelRatio(dpr);
+    m_windowIconImage.image = image;
+}
+
+void QuickCompactTitleBarPrivate::rasterizeButtons(const qreal dpr)
+{
+    if (kButtonCount <= 0) {
+        return;
+    }
+    const int pointSize = FramelessManagerPrivate::getIconFont().pointSize();
+    const bool active = isActive();
+    for (int index = 0; index != kButtonCount; ++index) {
+        const QString glyph = Utils::getSystemButtonGlyph(FRAMELESSHELPER_ENUM_QUICK_TO_CORE(SystemButtonType, buttonType(index)));
+        if (glyph.isEmpty()) {
+            m_buttonImages[index] = {};
+            continue;
+        }
+        const bool hovered = (m_hoveredButton == index);
+        const QColor color = [this, hovered, active]() -> QColor {
+            if (!hovered && !active) {
+                const QColor inactive = m_chromePalette->titleBarInactiveForegroundColor();
+                if (inactive.isValid()) {
+                    return inactive;
+                }
+            }
+            const QColor activeColor = m_chromePalette->titleBarActiveForegroundColor();
+            if (activeColor.isValid()) {
+                return activeColor;
+            }
+            return kDefaultBlackColor;
+        }();
+        // The glyph pixmaps are shared by all the system buttons of the whole application,
+        // most of the time this is just a cache lookup.
+        const QPixmap pixmap = FramelessManagerPrivate::getGlyphPixmap(glyph, color, pointSize, dpr);
+        if (pixmap.isNull()) {
+            m_buttonImages[index] = {};
+            continue;
+        }
+        if (!m_buttonImages[index].image.isNull() && (m_buttonImages[index].sourceKey == pixmap.cacheKey())) {
+            continue;
+        }
+        QImage image = pixmap.toImage();
+        image.setDevicePixelRatio(pixmap.devicePixelRatio());
+        m_buttonImages[index] = {image, pixmap.cacheKey()};
+    }
+}
+
+QSGNode *QuickCompactTitleBarPrivate::updatePaintNode(QSGNode *oldNode)
+{
+    Q_Q(QuickCompactTitleBar);
+    QQuickWindow * const window = q->window();
+    if (!window) {
+        delete oldNode;
+        return nullptr;
+    }
+    auto node = static_cast<CompactTitleBarNode *>(oldNode);
+    if (!node) {
+        node = new CompactTitleBarNode;
+    }
+    const bool active = isActive();
+    node->setRect(q->boundingRect());
+    node->setColor(active ?
+        m_chromePalette->titleBarActiveBackgroundColor() :
+        m_chromePalette->titleBarInactiveBackgroundColor());
+    // Child nodes are dirt cheap, the textures they refer to are kept in the root node.
+    while (QSGNode * const child = node->firstChild()) {
+        delete child;
+    }
+    for (int index = 0; index != kButtonCount; ++index) {
+        const QRectF rect = buttonRect(index);
+        const bool close = (buttonType(index) == QuickGlobal::SystemButtonType::Close);
+        const QColor backgroundColor = [this, index, close]() -> QColor {
+            if (m_pressedButton == index) {
+                return (close ? m_chromePalette->closeButtonPressColor() : m_chromePalette->chromeButtonPressColor());
+            }
+            if (m_hoveredButton == index) {
+                return (close ? m_chromePalette->closeButtonHoverColor() : m_chromePalette->chromeButtonHoverColor());
+            }
+            return (close ? m_chromePalette->closeButtonNormalColor() : m_chromePalette->chromeButtonNormalColor());
+        }();
+        if (backgroundColor.isValid() && (backgroundColor.alpha() > 0)) {
+            node->appendChildNode(new QSGSimpleRectNode(rect, backgroundColor));
+        }
+        const QImage &glyph = m_buttonImages[index].image;
+        const QSizeF glyphSize = imageLogicalSize(glyph);
+        const QPointF glyphPos = {
+            std::round(rect.x() + ((rect.width() - glyphSize.width()) / qreal(2))),
+            std::round(rect.y() + ((rect.height() - glyphSize.height()) / qreal(2)))
+        };
+        appendTextureNode(node, uploadImage(window, node->buttons[index], glyph), QRectF(glyphPos, glyphSize));
+    }
+    if (windowIconVisible_real()) {
+        const QRectF iconRect = windowIconRect();
+        QRectF imageRect = {QPointF(0, 0), imageLogicalSize(m_windowIconImage.image)};
+        imageRect.moveCenter(iconRect.center());
+        appendTextureNode(node, uploadImage(window, node->windowIcon, m_windowIconImage.image), imageRect);
+    } else {
+        node->windowIcon = {};
+    }
+    const QRectF titleRect = this->titleRect();
+    const QPointF titlePos = {std::round(titleRect.x()), std::round(titleRect.y())};
+    appendTextureNode(node, uploadImage(window, node->title, m_titleImage.image),
+        QRectF(titlePos, imageLogicalSize(m_titleImage.image)));
+    return node;
+}
+
+void QuickCompactTitleBarPrivate::setHoveredButton(const int index)
+{
+    if (m_hoveredButton == index) {
+        return;
+    }
+    m_hoveredButton = index;
+    invalidate();
+}
+
+void QuickCompactTitleBarPrivate::setPressedButton(const int index)
+{
+    if (m_pressedButton == index) {
+        return;
+    }
+    m_pressedButton = index;
+    invalidate();
+}
+
+void QuickCompactTitleBarPrivate::mouseReleaseHandler(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return;
+    }
+    Q_Q(QuickCompactTitleBar);
+    const Qt::MouseButton button = event->button();
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->localPos();
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    if (m_pressedButton >= 0) {
+        const int index = m_pressedButton;
+        setPressedButton(-1);
+        if ((button == Qt::LeftButton) && (buttonAt(pos) == index)) {
+            clickButton(index);
+        }
+        return;
+    }
+    if (!isInTitleBarIconArea(pos)) {
+        return;
+    }
+    // Same as the standard title bar: wait a little bit, otherwise we'd never know
+    // whether this release is part of a double click or not.
+    QTimer::singleShot(150, this, [this, q, button, pos](){
+        // The close event is already triggered, don't try to show the
+        // system menu anymore, otherwise it will prevent our window
+        // from closing.
+        if (m_closeTriggered) {
+            return;
+        }
+        const QPointF menuPos = ((button == Qt::LeftButton) ? QPointF(0, q->height()) : pos);
+        FramelessQuickHelper::get(q)->showSystemMenu(q->mapToGlobal(menuPos).toPoint());
+    });
+}
+
+bool QuickCompactTitleBarPrivate::mouseDoubleClickHandler(QMouseEvent *event)
+{
+    Q_ASSERT(event);
+    if (!event) {
+        return false;
+    }
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->localPos();
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    if ((event->button() != Qt::LeftButton) || !isInTitleBarIconArea(pos) || !m_window) {
+        return false;
+    }
+    m_closeTriggered = true;
+    m_window->close();
+    return true;
+}
+
+void QuickCompactTitleBarPrivate::invalidate()
+{
+    Q_Q(QuickCompactTitleBar);
+    q->polish();
+    q->update();
+}
+
+void QuickCompactTitleBarPrivate::updateHitTestRects()
+{
+    Q_Q(QuickCompactTitleBar);
+    if (!q->window()) {
+        return;
+    }
+    QList<QRect> rects = {};
+    for (int index = 0; index != kButtonCount; ++index) {
+        rects.append(q->mapRectToScene(buttonRect(index)).toAlignedRect());
+    }
+    if (windowIconVisible_real()) {
+        rects.append(q->mapRectToScene(windowIconRect()).toAlignedRect());
+    }
+    if (rects == m_hitTestVisibleRects) {
+        return;
+    }
+    // Our buttons are not items, so tell the helper about their areas directly,
+    // otherwise clicking on them would start dragging the window instead.
+    FramelessQuickHelper * const helper = FramelessQuickHelper::get(q);
+    for (auto &&rect : std::as_const(m_hitTestVisibleRects)) {
+        helper->setHitTestVisible_rect(rect, false);
+    }
+    m_hitTestVisibleRects = rects;
+    for (auto &&rect : std::as_const(m_hitTestVisibleRects)) {
+        helper->setHitTestVisible_rect(rect, true);
+    }
+}
+
+void QuickCompactTitleBarPrivate::rebindWindow(QQuickWindow *window)
+{
+    if (m_windowStateChangeConnection) {
+        disconnect(m_windowStateChangeConnection);
+        m_windowStateChangeConnection = {};
+    }
+    if (m_windowActiveChangeConnection) {
+        disconnect(m_windowActiveChangeConnection);
+        m_windowActiveChangeConnection = {};
+    }
+    if (m_windowTitleChangeConnection) {
+        disconnect(m_windowTitleChangeConnection);
+        m_windowTitleChangeConnection = {};
+    }
+    // The rectangles belong to the previous window.
+    m_hitTestVisibleRects.clear();
+    m_window = window;
+    if (!m_window) {
+        return;
+    }
+    m_windowStateChangeConnection = connect(m_window, &QQuickWindow::visibilityChanged, this, &QuickCompactTitleBarPrivate::invalidate);
+    m_windowActiveChangeConnection = connect(m_window, &QQuickWindow::activeChanged, this, &QuickCompactTitleBarPrivate::invalidate);
+    m_windowTitleChangeConnection = connect(m_window, &QQuickWindow::windowTitleChanged, this, &QuickCompactTitleBarPrivate::invalidate);
+    invalidate();
+}
+
+void QuickCompactTitleBarPrivate::clickButton(const int index)
+{
+    QQuickWindow * const window = m_window;
+    if (!window) {
+        return;
+    }
+    switch (buttonType(index)) {
+    case QuickGlobal::SystemButtonType::Minimize:
+#ifndef FRAMELESSHELPER_QUICK_NO_PRIVATE
+        if (const auto _w = qobject_cast<FramelessQuickWindow *>(window)) {
+            _w->showMinimized2();
+            break;
+        }
+#endif // FRAMELESSHELPER_QUICK_NO_PRIVATE
+        window->setVisibility(QQuickWindow::Minimized);
+        break;
+    case QuickGlobal::SystemButtonType::Maximize:
+        window->setVisibility(QQuickWindow::Maximized);
+        break;
+    case QuickGlobal::SystemButtonType::Restore:
+        window->setVisibility(QQuickWindow::Windowed);
+        break;
+    case QuickGlobal::SystemButtonType::Close:
+        if (m_hideWhenClose) {
+            window->hide();
+        } else {
+            window->close();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void QuickCompactTitleBarPrivate::initialize()
+{
+    Q_Q(QuickCompactTitleBar);
+    FramelessManagerPrivate::initializeIconFont();
+    q->setFlag(QQuickItem::ItemHasContents);
+    q->setAcceptHoverEvents(true);
+    q->setAcceptedMouseButtons(Qt::LeftButton | Qt::RightButton);
+    q->setHeight(kDefaultTitleBarHeight);
+    m_chromePalette = new QuickChromePalette(this);
+    connect(m_chromePalette, &ChromePalette::paletteChanged,
+        this, &QuickCompactTitleBarPrivate::invalidate);
+    m_windowIconSize = kDefaultWindowIconSize;
+#ifdef Q_OS_MACOS
+    m_labelAlignment = Qt::AlignCenter;
+#else // !Q_OS_MACOS
+    m_labelAlignment = (Qt::AlignLeft | Qt::AlignVCenter);
+#endif // Q_OS_MACOS
+}
+
+QuickCompactTitleBar::QuickCompactTitleBar(QQuickItem *parent)
+    : QQuickItem(parent), d_ptr(new QuickCompactTitleBarPrivate(this))
+{
+}
+
+QuickCompactTitleBar::~QuickCompactTitleBar() = default;
+
+Qt::Alignment QuickCompactTitleBar::titleLabelAlignment() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_labelAlignment;
+}
+
+void QuickCompactTitleBar::setTitleLabelAlignment(const Qt::Alignment value)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->m_labelAlignment == value) {
+        return;
+    }
+    d->m_labelAlignment = value;
+    d->invalidate();
+    Q_EMIT titleLabelAlignmentChanged();
+}
+
+QFont QuickCompactTitleBar::titleFont() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->titleFont();
+}
+
+void QuickCompactTitleBar::setTitleFont(const QFont &value)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->titleFont() == value) {
+        return;
+    }
+    d->m_titleFont = value;
+    d->invalidate();
+    Q_EMIT titleFontChanged();
+}
+
+bool QuickCompactTitleBar::isExtended() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_extended;
+}
+
+void QuickCompactTitleBar::setExtended(const bool value)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->m_extended == value) {
+        return;
+    }
+    d->m_extended = value;
+    setHeight(d->m_extended ? kDefaultExtendedTitleBarHeight : kDefaultTitleBarHeight);
+    Q_EMIT extendedChanged();
+}
+
+bool QuickCompactTitleBar::isHideWhenClose() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_hideWhenClose;
+}
+
+void QuickCompactTitleBar::setHideWhenClose(const bool value)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->m_hideWhenClose == value) {
+        return;
+    }
+    d->m_hideWhenClose = value;
+    Q_EMIT hideWhenCloseChanged();
+}
+
+QuickChromePalette *QuickCompactTitleBar::chromePalette() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_chromePalette;
+}
+
+QSizeF QuickCompactTitleBar::windowIconSize() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_windowIconSize;
+}
+
+void QuickCompactTitleBar::setWindowIconSize(const QSizeF &value)
+{
+    Q_ASSERT(!value.isEmpty());
+    if (value.isEmpty()) {
+        return;
+    }
+    Q_D(QuickCompactTitleBar);
+    if (d->m_windowIconSize == value) {
+        return;
+    }
+    d->m_windowIconSize = value;
+    d->invalidate();
+    Q_EMIT windowIconSizeChanged();
+}
+
+bool QuickCompactTitleBar::windowIconVisible() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_windowIconVisible;
+}
+
+void QuickCompactTitleBar::setWindowIconVisible(const bool value)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->m_windowIconVisible == value) {
+        return;
+    }
+    d->m_windowIconVisible = value;
+    d->invalidate();
+    Q_EMIT windowIconVisibleChanged();
+}
+
+QVariant QuickCompactTitleBar::windowIcon() const
+{
+    Q_D(const QuickCompactTitleBar);
+    return d->m_windowIcon;
+}
+
+void QuickCompactTitleBar::setWindowIcon(const QVariant &value)
+{
+    Q_ASSERT(value.isValid());
+    if (!value.isValid()) {
+        return;
+    }
+    Q_D(QuickCompactTitleBar);
+    if (d->m_windowIcon == value) {
+        return;
+    }
+    d->m_windowIcon = value;
+    ++d->m_windowIconSerial;
+    d->invalidate();
+    Q_EMIT windowIconChanged();
+}
+
+QSGNode *QuickCompactTitleBar::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+    Q_D(QuickCompactTitleBar);
+    return d->updatePaintNode(oldNode);
+}
+
+void QuickCompactTitleBar::updatePolish()
+{
+    QQuickItem::updatePolish();
+    Q_D(QuickCompactTitleBar);
+    d->rasterize();
+    d->updateHitTestRects();
+}
+
+void QuickCompactTitleBar::itemChange(const ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    Q_D(QuickCompactTitleBar);
+    switch (change) {
+    case ItemSceneChange:
+        d->rebindWindow(value.window);
+        break;
+    case ItemDevicePixelRatioHasChanged:
+        d->invalidate();
+        break;
+    default:
+        break;
+    }
+}
+
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+void QuickCompactTitleBar::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    Q_D(QuickCompactTitleBar);
+    d->invalidate();
+}
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+void QuickCompactTitleBar::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    Q_D(QuickCompactTitleBar);
+    d->invalidate();
+}
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+
+void QuickCompactTitleBar::hoverMoveEvent(QHoverEvent *event)
+{
+    QQuickItem::hoverMoveEvent(event);
+    Q_D(QuickCompactTitleBar);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    d->setHoveredButton(d->buttonAt(event->position()));
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    d->setHoveredButton(d->buttonAt(event->posF()));
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+}
+
+void QuickCompactTitleBar::hoverLeaveEvent(QHoverEvent *event)
+{
+    QQuickItem::hoverLeaveEvent(event);
+    Q_D(QuickCompactTitleBar);
+    d->setHoveredButton(-1);
+}
+
+void QuickCompactTitleBar::mousePressEvent(QMouseEvent *event)
+{
+    Q_D(QuickCompactTitleBar);
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->position();
+#else // (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    const QPointF pos = event->localPos();
+#endif // (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
+    if (event->button() == Qt::LeftButton) {
+        const int index = d->buttonAt(pos);
+        if (index >= 0) {
+            d->setPressedButton(index);
+            event->accept();
+            return;
+        }
+    }
+    if (d->isInTitleBarIconArea(pos)) {
+        event->accept();
+        return;
+    }
+    // Everything else belongs to the draggable area, which is handled by FramelessHelper.
+    event->ignore();
+}
+
+void QuickCompactTitleBar::mouseReleaseEvent(QMouseEvent *event)
+{
+    Q_D(QuickCompactTitleBar);
+    d->mouseReleaseHandler(event);
+    event->accept();
+}
+
+void QuickCompactTitleBar::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_D(QuickCompactTitleBar);
+    if (d->mouseDoubleClickHandler(event)) {
+        event->accept();
+        return;
+    }
+    event->ignore();
+}
+
+void QuickCompactTitleBar::mouseUngrabEvent()
+{
+    QQuickItem::mouseUngrabEvent();
+    Q_D(QuickCompactTitleBar);
+    d->setPressedButton(-1);
+}
+
+void QuickCompactTitleBar::classBegin()
+{
+    QQuickItem::classBegin();
+}
+
+void QuickCompactTitleBar::componentComplete()
+{
+    QQuickItem::componentComplete();
+}
+
+FRAMELESSHELPER_END_NAMESPACE
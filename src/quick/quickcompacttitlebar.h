@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Quick/quickcompacttitlebar.h"
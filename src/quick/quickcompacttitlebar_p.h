@@ -0,0 +1 @@
+#include "../../include/FramelessHelper/Quick/private/quickcompacttitlebar_p.h"
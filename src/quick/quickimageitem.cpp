@@ -24,11 +24,13 @@
 
 #include "quickimageitem.h"
 #include "quickimageitem_p.h"
+#include <FramelessHelper/Core/private/cachebudget_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qpainter.h>
 #include <QtGui/qimage.h>
 #include <QtGui/qpixmap.h>
 #include <QtGui/qicon.h>
+#include <QtQuick/qquickwindow.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -63,7 +65,10 @@ QuickImageItemPrivate::QuickImageItemPrivate(QuickImageItem *q) : QObject(q)
     initialize();
 }
 
-QuickImageItemPrivate::~QuickImageItemPrivate() = default;
+QuickImageItemPrivate::~QuickImageItemPrivate()
+{
+    CacheBudget::instance()->addUsage(CacheBudget::Cache::Images, -m_memoryUsage);
+}
 
 QuickImageItemPrivate *QuickImageItemPrivate::get(QuickImageItem *q)
 {
@@ -92,6 +97,7 @@ void QuickImageItemPrivate::paint(QPainter *painter) const
     if (!m_source.isValid() || m_source.isNull()) {
         return;
     }
+    updateMemoryUsage();
     painter->save();
     painter->setRenderHints(QPainter::Antialiasing |
         QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
@@ -223,6 +229,22 @@ QRectF QuickImageItemPrivate::paintArea() const
     return {QPointF(0, 0), size};
 }
 
+void QuickImageItemPrivate::updateMemoryUsage() const
+{
+    // QQuickPaintedItem keeps a backing image of the item's size around, that's what
+    // costs the memory, the source itself is owned by the user.
+    Q_Q(const QuickImageItem);
+    const QQuickWindow * const window = q->window();
+    const qreal devicePixelRatio = (window ? window->effectiveDevicePixelRatio() : qreal(1));
+    const QSize size = QSizeF(paintArea().size() * devicePixelRatio).toSize();
+    const qint64 bytes = (qint64(size.width()) * qint64(size.height()) * 4);
+    if (bytes == m_memoryUsage) {
+        return;
+    }
+    CacheBudget::instance()->addUsage(CacheBudget::Cache::Images, (bytes - m_memoryUsage));
+    m_memoryUsage = bytes;
+}
+
 QuickImageItem::QuickImageItem(QQuickItem *parent)
     : QQuickPaintedItem(parent), d_ptr(new QuickImageItemPrivate(this))
 {
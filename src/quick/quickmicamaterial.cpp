@@ -25,6 +25,7 @@
 #include "quickmicamaterial.h"
 #include "quickmicamaterial_p.h"
 #include <FramelessHelper/Core/micamaterial.h>
+#include <FramelessHelper/Core/private/micamaterial_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtQuick/qquickwindow.h>
 #ifndef FRAMELESSHELPER_QUICK_NO_PRIVATE
@@ -114,7 +115,8 @@ void QuickMicaMaterialPrivate::initialize()
 void QuickMicaMaterialPrivate::rebindWindow()
 {
     Q_Q(QuickMicaMaterial);
-    const QQuickWindow * const window = q->window();
+    QQuickWindow * const window = q->window();
+    MicaMaterialPrivate::get(m_micaMaterial)->setWindow(window);
     if (!window) {
         return;
     }
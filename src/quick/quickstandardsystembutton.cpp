@@ -118,6 +118,11 @@ qreal QuickStandardSystemButton::iconSize() const
     return -1;
 }
 
+QString QuickStandardSystemButton::toolTip() const
+{
+    return m_toolTip;
+}
+
 void QuickStandardSystemButton::setButtonType(const QuickGlobal::SystemButtonType type)
 {
     Q_ASSERT(type != QuickGlobal::SystemButtonType::Unknown);
@@ -232,6 +237,20 @@ void QuickStandardSystemButton::setIconSize(const qreal value)
     Q_EMIT iconSizeChanged();
 }
 
+void QuickStandardSystemButton::setToolTip(const QString &value)
+{
+    if (m_toolTip == value) {
+        return;
+    }
+    m_toolTip = value;
+    // Only update the tooltip if it has been created already, otherwise
+    // the text will be applied the first time it needs to be shown.
+    if (QQuickToolTipAttached * const attached = toolTipAttached(false)) {
+        attached->setText(m_toolTip);
+    }
+    Q_EMIT toolTipChanged();
+}
+
 void QuickStandardSystemButton::updateColor()
 {
     const bool hover = isHovered();
@@ -258,7 +277,15 @@ void QuickStandardSystemButton::updateColor()
         }
         return kDefaultTransparentColor;
     }());
-    qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(this))->setVisible(hover || press);
+    // Creating the attached tooltip also brings in the popup machinery behind it,
+    // so don't do it before the button is hovered or pressed for the first time.
+    const bool toolTipVisible = (hover || press);
+    if (QQuickToolTipAttached * const attached = toolTipAttached(toolTipVisible && !m_toolTip.isEmpty())) {
+        if (!m_toolTip.isEmpty()) {
+            attached->setText(m_toolTip);
+        }
+        attached->setVisible(toolTipVisible);
+    }
 }
 
 void QuickStandardSystemButton::initialize()
@@ -291,6 +318,11 @@ void QuickStandardSystemButton::initialize()
     setBackground(m_backgroundItem);
 }
 
+QQuickToolTipAttached *QuickStandardSystemButton::toolTipAttached(const bool create) const
+{
+    return qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(this, create));
+}
+
 void QuickStandardSystemButton::classBegin()
 {
     QQuickButton::classBegin();
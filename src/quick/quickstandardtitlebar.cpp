@@ -37,7 +37,6 @@
 #include <QtQuick/private/qquickanchors_p.h>
 #include <QtQuick/private/qquickanchors_p_p.h>
 #include <QtQuick/private/qquickpositioners_p.h>
-#include <QtQuickTemplates2/private/qquicktooltip_p.h>
 
 FRAMELESSHELPER_BEGIN_NAMESPACE
 
@@ -247,7 +246,7 @@ void QuickStandardTitleBar::updateMaximizeButton()
     }
     const bool max = (w->visibility() == QQuickWindow::Maximized);
     m_maximizeButton->setButtonType(max ? QuickGlobal::SystemButtonType::Restore : QuickGlobal::SystemButtonType::Maximize);
-    qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_maximizeButton))->setText(max ? tr("Restore") : tr("Maximize"));
+    m_maximizeButton->setToolTip(max ? tr("Restore") : tr("Maximize"));
 #endif // Q_OS_MACOS
 }
 
@@ -310,6 +309,12 @@ void QuickStandardTitleBar::updateChromeButtonColor()
 #endif // Q_OS_MACOS
 }
 
+void QuickStandardTitleBar::updateColors()
+{
+    updateTitleBarColor();
+    updateChromeButtonColor();
+}
+
 void QuickStandardTitleBar::clickMinimizeButton()
 {
     QQuickWindow * const w = window();
@@ -352,8 +357,8 @@ void QuickStandardTitleBar::clickCloseButton()
 void QuickStandardTitleBar::retranslateUi()
 {
 #ifndef Q_OS_MACOS
-    qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_minimizeButton))->setText(tr("Minimize"));
-    qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_maximizeButton))->setText([this]() -> QString {
+    m_minimizeButton->setToolTip(tr("Minimize"));
+    m_maximizeButton->setToolTip([this]() -> QString {
         if (const QQuickWindow * const w = window()) {
             if (w->visibility() == QQuickWindow::Maximized) {
                 return tr("Restore");
@@ -361,7 +366,7 @@ void QuickStandardTitleBar::retranslateUi()
         }
         return tr("Maximize");
     }());
-    qobject_cast<QQuickToolTipAttached *>(qmlAttachedPropertiesObject<QQuickToolTip>(m_closeButton))->setText(tr("Close"));
+    m_closeButton->setToolTip(tr("Close"));
 #endif // Q_OS_MACOS
 }
 
@@ -483,10 +488,8 @@ void QuickStandardTitleBar::initialize()
     setAntialiasing(true);
 
     m_chromePalette = new QuickChromePalette(this);
-    connect(m_chromePalette, &ChromePalette::titleBarColorChanged,
-        this, &QuickStandardTitleBar::updateTitleBarColor);
-    connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged,
-        this, &QuickStandardTitleBar::updateChromeButtonColor);
+    connect(m_chromePalette, &ChromePalette::paletteChanged,
+        this, &QuickStandardTitleBar::updateColors);
 
     QQuickPen * const b = border();
     b->setWidth(0.0);
@@ -557,10 +560,7 @@ void QuickStandardTitleBar::itemChange(const ItemChange change, const ItemChange
             m_windowTitleChangeConnection = {};
         }
         m_windowStateChangeConnection = connect(value.window, &QQuickWindow::visibilityChanged, this, &QuickStandardTitleBar::updateMaximizeButton);
-        m_windowActiveChangeConnection = connect(value.window, &QQuickWindow::activeChanged, this, [this](){
-            updateTitleBarColor();
-            updateChromeButtonColor();
-        });
+        m_windowActiveChangeConnection = connect(value.window, &QQuickWindow::activeChanged, this, &QuickStandardTitleBar::updateColors);
         m_windowTitleChangeConnection = connect(value.window, &QQuickWindow::windowTitleChanged, this, &QuickStandardTitleBar::updateTitleLabelText);
         updateAll();
         value.window->installEventFilter(this);
@@ -604,8 +604,7 @@ void QuickStandardTitleBar::updateAll()
     updateWindowIcon();
     updateMaximizeButton();
     updateTitleLabelText();
-    updateTitleBarColor();
-    updateChromeButtonColor();
+    updateColors();
 }
 
 void QuickStandardTitleBar::classBegin()
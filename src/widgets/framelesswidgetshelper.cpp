@@ -34,7 +34,10 @@
 #include <FramelessHelper/Core/framelessmanager.h>
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
+#include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <FramelessHelper/Core/private/framelesshelpercore_global_p.h>
+#include <FramelessHelper/Core/private/tracing_p.h>
+#include <FramelessHelper/Core/private/statistics_p.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qtimer.h>
 #include <QtCore/qeventloop.h>
@@ -517,6 +520,7 @@ void FramelessWidgetsHelperPrivate::setHitTestVisible(QObject *object, const boo
 
 void FramelessWidgetsHelperPrivate::attach()
 {
+    FRAMELESSHELPER_TRACE_SCOPE("helper", "FramelessWidgetsHelper::attach");
     QWidget * const window = findTopLevelWindow();
     Q_ASSERT(window);
     if (!window) {
@@ -527,6 +531,14 @@ void FramelessWidgetsHelperPrivate::attach()
     }
     m_window = window;
 
+    // The shadow is painted inside the window, around its content. This only has
+    // an effect if the window hasn't been shown yet.
+    const bool clientSideShadow = (FramelessConfig::instance()->isSet(Option::WindowUseClientSideShadow)
+        && FramelessManagerPrivate::usePureQtImplementation());
+    if (clientSideShadow && !window->testAttribute(Qt::WA_TranslucentBackground)) {
+        window->setAttribute(Qt::WA_TranslucentBackground);
+    }
+
     if (!window->testAttribute(Qt::WA_DontCreateNativeAncestors)) {
         window->setAttribute(Qt::WA_DontCreateNativeAncestors);
     }
@@ -579,6 +591,13 @@ void FramelessWidgetsHelperPrivate::attach()
     data->params = params;
     data->ready = true;
 
+    if (clientSideShadow) {
+        // Someone has to paint it, the shared helper does that for all kinds of windows.
+        if (WidgetsSharedHelper * const helper = findOrCreateSharedHelper(window)) {
+            helper->updateWindowShadow();
+        }
+    }
+
     // We have to wait for a little time before moving the top level window
     // , because the platform window may not finish initializing by the time
     // we reach here, and all the modifications from the Qt side will be lost
@@ -593,6 +612,7 @@ void FramelessWidgetsHelperPrivate::attach()
             setBlurBehindWindowEnabled(true, {});
         }
         emitSignalForAllInstances("windowChanged");
+        FRAMELESSHELPER_TRACE_INSTANT("helper", "FramelessWidgetsHelper::ready");
         emitSignalForAllInstances("ready");
     });
 }
@@ -685,6 +705,7 @@ QRect FramelessWidgetsHelperPrivate::mapWidgetGeometryToScene(const QWidget * co
 
 bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemButtonType *button) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessWidgetsHelper::isInSystemButtons");
     Q_ASSERT(button);
     if (!button) {
         return false;
@@ -729,6 +750,8 @@ bool FramelessWidgetsHelperPrivate::isInSystemButtons(const QPoint &pos, SystemB
 
 bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessWidgetsHelper::isInTitleBarDraggableArea");
+    const StatisticsTimer statisticsTimer(StatisticsRecorder::Histogram::HitTest);
     const FramelessWidgetsHelperData *data = getWindowData();
     if (!data) {
         return false;
@@ -783,11 +806,14 @@ bool FramelessWidgetsHelperPrivate::isInTitleBarDraggableArea(const QPoint &pos)
 
 bool FramelessWidgetsHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) const
 {
+    FRAMELESSHELPER_TRACE_SCOPE("hittest", "FramelessWidgetsHelper::shouldIgnoreMouseEvents");
     if (!m_window) {
         return false;
     }
     const auto withinFrameBorder = [this, &pos]() -> bool {
-        if (pos.y() < kDefaultResizeBorderThickness) {
+        const QWindow * const window = m_window->windowHandle();
+        const QMargins margins = (window ? Utils::windowShadowMargins(window) : QMargins{});
+        if (pos.y() < (margins.top() + kDefaultResizeBorderThickness)) {
             return true;
         }
 #ifdef Q_OS_WINDOWS
@@ -795,8 +821,8 @@ bool FramelessWidgetsHelperPrivate::shouldIgnoreMouseEvents(const QPoint &pos) c
             return false;
         }
 #endif
-        return ((pos.x() < kDefaultResizeBorderThickness)
-                || (pos.x() >= (m_window->width() - kDefaultResizeBorderThickness)));
+        return ((pos.x() < (margins.left() + kDefaultResizeBorderThickness))
+                || (pos.x() >= (m_window->width() - margins.right() - kDefaultResizeBorderThickness)));
     }();
     return ((Utils::windowStatesToWindowState(m_window->windowState()) == Qt::WindowNoState) && withinFrameBorder);
 }
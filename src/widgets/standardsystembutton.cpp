@@ -28,6 +28,7 @@
 #include <FramelessHelper/Core/private/framelessmanager_p.h>
 #include <QtCore/qloggingcategory.h>
 #include <QtGui/qpainter.h>
+#include <QtGui/qpixmap.h>
 #include <QtGui/qevent.h>
 #include <QtWidgets/qtooltip.h>
 
@@ -348,8 +349,6 @@ void StandardSystemButtonPrivate::paintEventHandler(QPaintEvent *event)
     Q_Q(StandardSystemButton);
     QPainter painter(q);
     painter.save();
-    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing
-                           | QPainter::SmoothPixmapTransform);
     const auto backgroundColor = [this]() -> QColor {
         // The pressed state has higher priority than the hovered state.
         if (m_pressed && m_pressColor.isValid()) {
@@ -368,7 +367,7 @@ void StandardSystemButtonPrivate::paintEventHandler(QPaintEvent *event)
         painter.fillRect(buttonRect, backgroundColor);
     }
     if (!m_glyph.isEmpty()) {
-        painter.setPen([this]() -> QColor {
+        const QColor foregroundColor = [this]() -> QColor {
             if (!m_hovered && !m_active && m_inactiveForegroundColor.isValid()) {
                 return m_inactiveForegroundColor;
             }
@@ -376,15 +375,19 @@ void StandardSystemButtonPrivate::paintEventHandler(QPaintEvent *event)
                 return m_activeForegroundColor;
             }
             return kDefaultBlackColor;
-        }());
-        painter.setFont([this]() -> QFont {
-            QFont font = FramelessManagerPrivate::getIconFont();
-            if (m_iconSize2.has_value()) {
-                font.setPointSize(m_iconSize2.value());
-            }
-            return font;
-        }());
-        painter.drawText(buttonRect, Qt::AlignCenter, m_glyph);
+        }();
+        // The glyph is rasterized only once per (glyph, color, size, scale factor) and
+        // shared across all the system buttons, so we only need a plain blit here.
+        const QPixmap glyph = FramelessManagerPrivate::getGlyphPixmap(
+            m_glyph, foregroundColor, iconSize2(), q->devicePixelRatioF());
+        if (!glyph.isNull()) {
+            const QSizeF glyphSize = (QSizeF(glyph.size()) / glyph.devicePixelRatio());
+            const QPoint glyphPos = {
+                int(std::round((qreal(buttonRect.width()) - glyphSize.width()) / qreal(2))),
+                int(std::round((qreal(buttonRect.height()) - glyphSize.height()) / qreal(2)))
+            };
+            painter.drawPixmap(glyphPos, glyph);
+        }
     }
     painter.restore();
     event->accept();
@@ -144,21 +144,86 @@ QFont StandardTitleBarPrivate::defaultFont() const
 }
 
 StandardTitleBarPrivate::FontMetrics StandardTitleBarPrivate::titleLabelSize() const
+{
+    const TitleLabelCache *cache = titleLabelCache();
+    if (!cache) {
+        return {};
+    }
+    return cache->metrics;
+}
+
+const StandardTitleBarPrivate::TitleLabelCache *StandardTitleBarPrivate::titleLabelCache() const
+{
+    if (!m_window) {
+        return nullptr;
+    }
+    // Shaping the title text is not cheap, and the title bar gets repainted each time
+    // the mouse hovers over the system buttons, so we only re-layout the text when the
+    // title or the font really changes. The color is not part of the cache because
+    // it's applied by the painter when drawing.
+    if (!m_titleLabelCache.has_value()) {
+        const QString text = m_window->windowTitle();
+        if (text.isEmpty()) {
+            return nullptr;
+        }
+        const QFont font = m_titleFont.value_or(defaultFont());
+        const QFontMetrics fontMetrics(font);
+        TitleLabelCache cache = {};
+        cache.text = text;
+        cache.font = font;
+        cache.metrics = {
+            /* .width */ Utils::horizontalAdvance(fontMetrics, text),
+            /* .height */ fontMetrics.height(),
+            /* .ascent */ fontMetrics.ascent()
+        };
+        cache.staticText.setText(text);
+        cache.staticText.setTextFormat(Qt::PlainText);
+        cache.staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+        cache.staticText.prepare({}, font);
+        m_titleLabelCache = cache;
+    }
+    return &m_titleLabelCache.value();
+}
+
+QPixmap StandardTitleBarPrivate::windowIconPixmap() const
 {
     if (!m_window) {
         return {};
     }
-    const QString text = m_window->windowTitle();
-    if (text.isEmpty()) {
+    Q_Q(const StandardTitleBar);
+    const QSize size = windowIconSize();
+    const qreal dpr = q->devicePixelRatioF();
+    if (m_windowIconCache.has_value()
+        && (m_windowIconCache->size == size)
+        && qFuzzyCompare(m_windowIconCache->devicePixelRatio, dpr)) {
+        return m_windowIconCache->pixmap;
+    }
+    const QIcon icon = m_window->windowIcon();
+    if (icon.isNull()) {
         return {};
     }
-    const QFont font = m_titleFont.value_or(defaultFont());
-    const QFontMetrics fontMetrics(font);
-    return {
-        /* .width */ Utils::horizontalAdvance(fontMetrics, text),
-        /* .height */ fontMetrics.height(),
-        /* .ascent */ fontMetrics.ascent()
-    };
+    // Rasterize the icon at the exact device pixel size once, so that painting it
+    // later is a plain blit without any scaling or icon engine lookups.
+    QPixmap pixmap(QSizeF(QSizeF(size) * dpr).toSize());
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(kDefaultTransparentColor);
+    {
+        QPainter painter(&pixmap);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        icon.paint(&painter, QRect(QPoint(0, 0), size));
+    }
+    m_windowIconCache = WindowIconCache{ size, dpr, pixmap };
+    return pixmap;
+}
+
+void StandardTitleBarPrivate::invalidateTitleLabelCache()
+{
+    m_titleLabelCache = std::nullopt;
+}
+
+void StandardTitleBarPrivate::invalidateWindowIconCache()
+{
+    m_windowIconCache = std::nullopt;
 }
 
 void StandardTitleBarPrivate::paintTitleBar(QPaintEvent *event)
@@ -180,16 +245,15 @@ void StandardTitleBarPrivate::paintTitleBar(QPaintEvent *event)
         m_chromePalette->titleBarInactiveForegroundColor());
     QPainter painter(q);
     painter.save();
-    painter.setRenderHints(QPainter::Antialiasing |
-        QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    // Both the background and the cached pixmaps are pixel aligned, only the text needs antialiasing.
+    painter.setRenderHint(QPainter::TextAntialiasing);
     painter.fillRect(QRect(QPoint(0, 0), q->size()), backgroundColor);
     if (m_titleLabelVisible) {
-        const QString text = m_window->windowTitle();
-        if (!text.isEmpty()) {
+        if (const TitleLabelCache *cache = titleLabelCache()) {
             painter.setPen(foregroundColor);
-            painter.setFont(m_titleFont.value_or(defaultFont()));
-            const auto pos = [this, q]() -> QPoint {
-                const FontMetrics labelSize = titleLabelSize();
+            painter.setFont(cache->font);
+            const auto pos = [this, q, cache]() -> QPoint {
+                const FontMetrics &labelSize = cache->metrics;
                 const int titleBarWidth = q->width();
                 int x = 0;
                 if (m_labelAlignment & Qt::AlignLeft) {
@@ -207,13 +271,14 @@ void StandardTitleBarPrivate::paintTitleBar(QPaintEvent *event)
                 const int y = std::round((qreal(q->height() - labelSize.height) / qreal(2)) + qreal(labelSize.ascent));
                 return {x, y};
             }();
-            painter.drawText(pos, text);
+            // QStaticText is positioned by its top-left corner rather than the baseline.
+            painter.drawStaticText(QPoint(pos.x(), pos.y() - cache->metrics.ascent), cache->staticText);
         }
     }
     if (m_windowIconVisible) {
-        const QIcon icon = m_window->windowIcon();
-        if (!icon.isNull()) {
-            icon.paint(&painter, windowIconRect());
+        const QPixmap pixmap = windowIconPixmap();
+        if (!pixmap.isNull()) {
+            painter.drawPixmap(windowIconRect().topLeft(), pixmap);
         }
     }
     painter.restore();
@@ -251,6 +316,7 @@ void StandardTitleBarPrivate::setWindowIconSize(const QSize &value)
         return;
     }
     m_windowIconSize = value;
+    invalidateWindowIconCache();
     Q_Q(StandardTitleBar);
     q->update();
     Q_EMIT q->windowIconSizeChanged();
@@ -293,6 +359,7 @@ void StandardTitleBarPrivate::setTitleFont(const QFont &value)
         return;
     }
     m_titleFont = value;
+    invalidateTitleLabelCache();
     Q_Q(StandardTitleBar);
     q->update();
     Q_EMIT q->titleFontChanged();
@@ -430,6 +497,12 @@ void StandardTitleBarPrivate::updateTitleBarColor()
     q->update();
 }
 
+void StandardTitleBarPrivate::updateColors()
+{
+    updateTitleBarColor();
+    updateChromeButtonColor();
+}
+
 void StandardTitleBarPrivate::updateChromeButtonColor()
 {
 #ifndef Q_OS_MACOS
@@ -479,6 +552,13 @@ bool StandardTitleBarPrivate::eventFilter(QObject *object, QEvent *event)
     if (!object->isWidgetType()) {
         return QObject::eventFilter(object, event);
     }
+    if (object == q_ptr) {
+        // The default title font is derived from the title bar's own font.
+        if (event->type() == QEvent::FontChange) {
+            invalidateTitleLabelCache();
+        }
+        return QObject::eventFilter(object, event);
+    }
     const auto widget = qobject_cast<QWidget *>(object);
     if (!widget->isWindow() || (widget != m_window)) {
         return QObject::eventFilter(object, event);
@@ -488,8 +568,7 @@ bool StandardTitleBarPrivate::eventFilter(QObject *object, QEvent *event)
         updateMaximizeButton();
         break;
     case QEvent::ActivationChange:
-        updateTitleBarColor();
-        updateChromeButtonColor();
+        updateColors();
         break;
     case QEvent::LanguageChange:
         retranslateUi();
@@ -505,18 +584,18 @@ void StandardTitleBarPrivate::initialize()
     Q_Q(StandardTitleBar);
     m_window = q->window();
     m_chromePalette = new ChromePalette(this);
-    connect(m_chromePalette, &ChromePalette::titleBarColorChanged,
-        this, &StandardTitleBarPrivate::updateTitleBarColor);
-    connect(m_chromePalette, &ChromePalette::chromeButtonColorChanged,
-        this, &StandardTitleBarPrivate::updateChromeButtonColor);
+    connect(m_chromePalette, &ChromePalette::paletteChanged,
+        this, &StandardTitleBarPrivate::updateColors);
     q->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
     q->setFixedHeight(kDefaultTitleBarHeight);
-    connect(m_window, &QWidget::windowIconChanged, this, [q](const QIcon &icon){
+    connect(m_window, &QWidget::windowIconChanged, this, [this, q](const QIcon &icon){
         Q_UNUSED(icon);
+        invalidateWindowIconCache();
         q->update();
     });
-    connect(m_window, &QWidget::windowTitleChanged, this, [q](const QString &title){
+    connect(m_window, &QWidget::windowTitleChanged, this, [this, q](const QString &title){
         Q_UNUSED(title);
+        invalidateTitleLabelCache();
         q->update();
     });
 #ifdef Q_OS_MACOS
@@ -568,9 +647,9 @@ void StandardTitleBarPrivate::initialize()
     setTitleLabelAlignment(Qt::AlignLeft | Qt::AlignVCenter);
 #endif // Q_OS_MACOS
     retranslateUi();
-    updateTitleBarColor();
-    updateChromeButtonColor();
+    updateColors();
     m_window->installEventFilter(this);
+    q->installEventFilter(this);
 }
 
 StandardTitleBar::StandardTitleBar(QWidget *parent)
@@ -23,11 +23,14 @@
  */
 
 #include "widgetssharedhelper_p.h"
+#include <FramelessHelper/Core/framelesshelper_qt.h>
 #include <FramelessHelper/Core/micamaterial.h>
 #include <FramelessHelper/Core/utils.h>
 #include <FramelessHelper/Core/windowborderpainter.h>
+#include <FramelessHelper/Core/windowshadowpainter.h>
 #include <FramelessHelper/Core/private/framelessconfig_p.h>
 #include <FramelessHelper/Core/private/micamaterial_p.h>
+#include <FramelessHelper/Core/private/windowcornermask_p.h>
 #ifdef Q_OS_WINDOWS
 #  include <FramelessHelper/Core/private/winverhelper_p.h>
 #endif // Q_OS_WINDOWS
@@ -55,6 +58,48 @@ FRAMELESSHELPER_BEGIN_NAMESPACE
 
 using namespace Global;
 
+// Clears the rounded corners once everything else has been painted. The paint event of
+// the window itself happens before any of its children paint, so this has to be a child
+// too, kept on top of all the other ones. The shadow behind the corners is cleared along
+// with them, so it has to be drawn there once more.
+class WindowCornerOverlay : public QWidget
+{
+public:
+    explicit WindowCornerOverlay(QWidget *parent) : QWidget(parent)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+        setAttribute(Qt::WA_NoSystemBackground);
+        setFocusPolicy(Qt::NoFocus);
+    }
+
+    ~WindowCornerOverlay() override = default;
+
+    void setShadowPainter(WindowShadowPainter *value)
+    {
+        if (m_shadowPainter == value) {
+            return;
+        }
+        m_shadowPainter = value;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        Q_UNUSED(event);
+        QPainter painter(this);
+        WindowCornerMask::eraseCorners(&painter, size(), kDefaultWindowCornerRadius);
+        if (m_shadowPainter) {
+            // The shadow has the same corners as we do, it only covers what has just been cleared.
+            painter.translate(-pos());
+            m_shadowPainter->paint(&painter, parentWidget()->size(), parentWidget()->isActiveWindow());
+        }
+    }
+
+private:
+    QPointer<WindowShadowPainter> m_shadowPainter;
+};
+
 WidgetsSharedHelper::WidgetsSharedHelper(QObject *parent) : QObject(parent)
 {
 }
@@ -93,8 +138,12 @@ void WidgetsSharedHelper::setup(QWidget *widget)
                 m_targetWidget->update();
             }
         });
+    // Let the material know when nobody can see it, so it can stop doing useless work.
+    MicaMaterialPrivate::get(m_micaMaterial)->setWindow(m_targetWidget->windowHandle());
     m_targetWidget->installEventFilter(this);
+    updateWindowShadow();
     updateContentsMargins();
+    updateCornerOverlay();
     m_targetWidget->update();
 #if (QT_VERSION >= QT_VERSION_CHECK(5, 14, 0))
     QScreen *screen = m_targetWidget->screen();
@@ -137,6 +186,50 @@ WindowBorderPainter *WidgetsSharedHelper::rawWindowBorder() const
     return m_borderPainter;
 }
 
+WindowShadowPainter *WidgetsSharedHelper::rawWindowShadow() const
+{
+    return m_shadowPainter;
+}
+
+void WidgetsSharedHelper::updateWindowShadow()
+{
+    if (!m_targetWidget) {
+        return;
+    }
+    const QWindow * const window = m_targetWidget->windowHandle();
+    WindowShadowPainter * const shadow = (window ? FramelessHelperQt::windowShadowPainter(window) : nullptr);
+    if (m_shadowPainter == shadow) {
+        return;
+    }
+    if (m_shadowRepaintConnection) {
+        disconnect(m_shadowRepaintConnection);
+        m_shadowRepaintConnection = {};
+    }
+    if (m_shadowMarginsConnection) {
+        disconnect(m_shadowMarginsConnection);
+        m_shadowMarginsConnection = {};
+    }
+    m_shadowPainter = shadow;
+    if (m_shadowPainter) {
+        m_shadowRepaintConnection = connect(m_shadowPainter,
+            &WindowShadowPainter::shouldRepaint, this, [this](){
+                if (m_targetWidget) {
+                    m_targetWidget->update();
+                }
+            });
+        m_shadowMarginsConnection = connect(m_shadowPainter,
+            &WindowShadowPainter::marginsChanged, this, [this](){
+                if (m_targetWidget) {
+                    updateContentsMargins();
+                    updateCornerOverlay();
+                }
+            });
+    }
+    updateContentsMargins();
+    updateCornerOverlay();
+    m_targetWidget->update();
+}
+
 bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
 {
     Q_ASSERT(object);
@@ -162,17 +255,30 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
         m_targetWidget->update();
         break;
     case QEvent::Paint: {
+        repaintShadow();
         repaintMica();
         repaintBorder();
     } break;
     case QEvent::WindowStateChange:
         if (event->type() == QEvent::WindowStateChange) {
             updateContentsMargins();
+            updateCornerOverlay();
             emitCustomWindowStateSignals();
         }
         break;
+    case QEvent::ChildAdded:
+        // Children added later would be stacked above the overlay.
+        if (m_cornerOverlay && (static_cast<QChildEvent *>(event)->child() != m_cornerOverlay.data())) {
+            m_cornerOverlay->raise();
+        }
+        break;
     case QEvent::Move:
+        m_targetWidget->update();
+        break;
     case QEvent::Resize:
+        if (m_cornerOverlay) {
+            m_cornerOverlay->setGeometry(shadowlessRect());
+        }
         m_targetWidget->update();
         break;
     default:
@@ -181,23 +287,71 @@ bool WidgetsSharedHelper::eventFilter(QObject *object, QEvent *event)
     return QObject::eventFilter(object, event);
 }
 
+QMargins WidgetsSharedHelper::shadowMargins() const
+{
+    return (m_shadowPainter ? m_shadowPainter->margins() : QMargins{});
+}
+
+QRect WidgetsSharedHelper::shadowlessRect() const
+{
+    return m_targetWidget->rect().marginsRemoved(shadowMargins());
+}
+
+void WidgetsSharedHelper::repaintShadow()
+{
+    if (!m_shadowPainter) {
+        return;
+    }
+    QPainter painter(m_targetWidget);
+    m_shadowPainter->paint(&painter, m_targetWidget->size(), m_targetWidget->isActiveWindow());
+    // The window is translucent now, nobody else fills its background anymore.
+    if (!m_micaEnabled) {
+        painter.fillRect(shadowlessRect(), m_targetWidget->palette().color(QPalette::Window));
+    }
+}
+
 void WidgetsSharedHelper::repaintMica()
 {
     if (!m_micaEnabled || !m_micaMaterial) {
         return;
     }
     QPainter painter(m_targetWidget);
-    const QRect rect = { m_targetWidget->mapToGlobal(QPoint(0, 0)), m_targetWidget->size() };
+    const QRect contentRect = shadowlessRect();
+    painter.translate(contentRect.topLeft());
+    const QRect rect = { m_targetWidget->mapToGlobal(contentRect.topLeft()), contentRect.size() };
     m_micaMaterial->paint(&painter, rect, m_targetWidget->isActiveWindow());
 }
 
+void WidgetsSharedHelper::updateCornerOverlay()
+{
+    // Opaque windows only get the (aliased) window shape, clearing their corners would paint them black.
+    const bool enabled = (m_targetWidget->testAttribute(Qt::WA_TranslucentBackground)
+        && (Utils::windowStatesToWindowState(m_targetWidget->windowState()) == Qt::WindowNoState)
+        && FramelessConfig::instance()->isSet(Option::WindowUseRoundCorners));
+    if (!enabled) {
+        if (m_cornerOverlay) {
+            m_cornerOverlay->hide();
+        }
+        return;
+    }
+    if (!m_cornerOverlay) {
+        m_cornerOverlay = new WindowCornerOverlay(m_targetWidget);
+    }
+    static_cast<WindowCornerOverlay *>(m_cornerOverlay.data())->setShadowPainter(m_shadowPainter);
+    m_cornerOverlay->setGeometry(shadowlessRect());
+    m_cornerOverlay->raise();
+    m_cornerOverlay->show();
+}
+
 void WidgetsSharedHelper::repaintBorder()
 {
     if ((Utils::windowStatesToWindowState(m_targetWidget->windowState()) != Qt::WindowNoState) || !m_borderPainter) {
         return;
     }
     QPainter painter(m_targetWidget);
-    m_borderPainter->paint(&painter, m_targetWidget->size(), m_targetWidget->isActiveWindow());
+    const QRect rect = shadowlessRect();
+    painter.translate(rect.topLeft());
+    m_borderPainter->paint(&painter, rect.size(), m_targetWidget->isActiveWindow());
 }
 
 void WidgetsSharedHelper::emitCustomWindowStateSignals()
@@ -232,6 +386,9 @@ void WidgetsSharedHelper::handleScreenChanged(QScreen *screen)
     }
     m_screen = screen;
     m_screenDpr = m_screen->devicePixelRatio();
+    if (m_micaEnabled && m_micaMaterial) {
+        MicaMaterialPrivate::get(m_micaMaterial)->prepareBlurredWallpaper(m_screen);
+    }
     if (m_screenDpiChangeConnection) {
         disconnect(m_screenDpiChangeConnection);
         m_screenDpiChangeConnection = {};
@@ -245,15 +402,20 @@ void WidgetsSharedHelper::handleScreenChanged(QScreen *screen)
             }
             m_screenDpr = currentDpr;
             if (m_micaEnabled && m_micaMaterial) {
-                MicaMaterialPrivate::get(m_micaMaterial)->maybeGenerateBlurredWallpaper(true);
+                // The blurred wallpaper only depends on the logical screen size, it will only
+                // be regenerated if that has changed too, otherwise we just need a repaint.
+                MicaMaterialPrivate::get(m_micaMaterial)->prepareBlurredWallpaper(m_screen);
+                m_targetWidget->update();
             }
         });
 }
 
 void WidgetsSharedHelper::updateContentsMargins()
 {
+    // Keep the children away from the shadow.
+    QMargins margins = shadowMargins();
 #ifdef Q_OS_WINDOWS
-    const auto margins = [this]() -> QMargins {
+    margins += [this]() -> QMargins {
         if (!Utils::isWindowFrameBorderVisible() || WindowsVersionHelper::isWin11OrGreater()) {
             return {};
         }
@@ -262,8 +424,13 @@ void WidgetsSharedHelper::updateContentsMargins()
         }
         return {0, kDefaultWindowFrameBorderThickness, 0, 0};
     }();
-    m_targetWidget->setContentsMargins(margins);
+#else
+    // Nothing of ours to apply, leave the user's own margins alone.
+    if (!m_shadowPainter) {
+        return;
+    }
 #endif
+    m_targetWidget->setContentsMargins(margins);
 }
 
 FRAMELESSHELPER_END_NAMESPACE
@@ -0,0 +1,235 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/private/desktopportalsettings_p.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qtimer.h>
+#include <QtDBus/qdbusargument.h>
+#include <QtDBus/qdbusconnection.h>
+#include <QtDBus/qdbusmessage.h>
+#include <QtDBus/qdbusmetatype.h>
+#include <QtDBus/qdbusvariant.h>
+#include <QtTest/qtest.h>
+#include <QtTest/qsignalspy.h>
+#include <memory>
+
+/*
+ * Checks DesktopPortalSettings against a mock org.freedesktop.portal.Settings
+ * implementation, which lives on a private session bus started just for this
+ * test, so neither the real portal nor the user's settings are involved.
+ * Needs "dbus-daemon" in PATH, the test is skipped otherwise.
+ */
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using PortalSettingsMap = QMap<QString, QVariantMap>;
+Q_DECLARE_METATYPE(PortalSettingsMap)
+
+FRAMELESSHELPER_STRING_CONSTANT2(PortalService, "org.freedesktop.portal.Desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalPath, "/org/freedesktop/portal/desktop")
+FRAMELESSHELPER_STRING_CONSTANT2(PortalSettingsInterface, "org.freedesktop.portal.Settings")
+FRAMELESSHELPER_STRING_CONSTANT2(AppearanceNamespace, "org.freedesktop.appearance")
+FRAMELESSHELPER_STRING_CONSTANT2(ColorSchemeKey, "color-scheme")
+FRAMELESSHELPER_STRING_CONSTANT2(AccentColorKey, "accent-color")
+FRAMELESSHELPER_STRING_CONSTANT(SettingChanged)
+FRAMELESSHELPER_STRING_CONSTANT2(PortalConnection, "framelesshelper-mock-portal")
+FRAMELESSHELPER_STRING_CONSTANT2(ClientConnection, "framelesshelper-portal-client")
+
+static constexpr const int kSignalTimeout = 5000; // ms
+
+class MockPortal : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.portal.Settings")
+
+public:
+    explicit MockPortal(QObject *parent = nullptr) : QObject(parent) {}
+    ~MockPortal() override = default;
+
+    void setConnection(const QDBusConnection &connection)
+    {
+        m_connection = std::make_unique<QDBusConnection>(connection);
+    }
+
+    void reset()
+    {
+        replyDelay = 0;
+        hasAppearance = true;
+        colorScheme = 1;
+        readAllCount = 0;
+    }
+
+    void emitSettingChanged(const QString &key, const QVariant &value)
+    {
+        QDBusMessage message = QDBusMessage::createSignal(kPortalPath, kPortalSettingsInterface, kSettingChanged);
+        message << kAppearanceNamespace << key << QVariant::fromValue(QDBusVariant(value));
+        QVERIFY(m_connection->send(message));
+    }
+
+public Q_SLOTS:
+    void ReadAll(const QStringList &namespaces, const QDBusMessage &message)
+    {
+        ++readAllCount;
+        PortalSettingsMap settings = {};
+        if (hasAppearance && namespaces.contains(kAppearanceNamespace)) {
+            QDBusArgument accentColor = {};
+            accentColor.beginStructure();
+            accentColor << 0.0 << 0.5 << 1.0;
+            accentColor.endStructure();
+            QVariantMap appearance = {};
+            appearance.insert(kColorSchemeKey, colorScheme);
+            appearance.insert(kAccentColorKey, QVariant::fromValue(accentColor));
+            settings.insert(kAppearanceNamespace, appearance);
+        }
+        const QDBusMessage reply = message.createReply(QVariant::fromValue(settings));
+        if (replyDelay <= 0) {
+            m_connection->send(reply);
+            return;
+        }
+        // A portal which is slow to start, the client must not wait for it.
+        message.setDelayedReply(true);
+        QTimer::singleShot(replyDelay, this, [this, reply](){ m_connection->send(reply); });
+    }
+
+public:
+    int replyDelay = 0;
+    bool hasAppearance = true;
+    uint colorScheme = 1; // PreferDark
+    int readAllCount = 0;
+
+private:
+    std::unique_ptr<QDBusConnection> m_connection = nullptr;
+};
+
+class DesktopPortalTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        qDBusRegisterMetaType<PortalSettingsMap>();
+        m_daemon = std::make_unique<QProcess>();
+        m_daemon->start(FRAMELESSHELPER_STRING_LITERAL("dbus-daemon"),
+            {FRAMELESSHELPER_STRING_LITERAL("--session"), FRAMELESSHELPER_STRING_LITERAL("--nofork"),
+             FRAMELESSHELPER_STRING_LITERAL("--print-address")});
+        if (!m_daemon->waitForStarted() || !m_daemon->waitForReadyRead()) {
+            QSKIP("Can't start a private D-Bus session bus.");
+        }
+        const QString address = QString::fromUtf8(m_daemon->readLine()).trimmed();
+        QVERIFY(!address.isEmpty());
+        QDBusConnection portalConnection = QDBusConnection::connectToBus(address, kPortalConnection);
+        QVERIFY(portalConnection.isConnected());
+        QVERIFY(QDBusConnection::connectToBus(address, kClientConnection).isConnected());
+        m_portal.setConnection(portalConnection);
+        QVERIFY(portalConnection.registerObject(kPortalPath, &m_portal, QDBusConnection::ExportAllSlots));
+        QVERIFY(portalConnection.registerService(kPortalService));
+    }
+
+    void cleanupTestCase()
+    {
+        QDBusConnection::disconnectFromBus(kClientConnection);
+        QDBusConnection::disconnectFromBus(kPortalConnection);
+        if (m_daemon) {
+            m_daemon->kill();
+            m_daemon->waitForFinished();
+        }
+    }
+
+    void init()
+    {
+        m_portal.reset();
+    }
+
+    void readsAppearanceAsynchronously()
+    {
+        m_portal.replyDelay = 500;
+        QElapsedTimer timer;
+        timer.start();
+        DesktopPortalSettings settings(kClientConnection);
+        QVERIFY(timer.elapsed() < m_portal.replyDelay);
+        QVERIFY(!settings.isInitialized());
+        QVERIFY(!settings.isAvailable());
+        QVERIFY(!settings.colorScheme().has_value());
+        QSignalSpy initializedSpy(&settings, &DesktopPortalSettings::initialized);
+        QSignalSpy colorSchemeSpy(&settings, &DesktopPortalSettings::colorSchemeChanged);
+        QVERIFY(initializedSpy.wait(kSignalTimeout));
+        QVERIFY(settings.isInitialized());
+        QVERIFY(settings.isAvailable());
+        QCOMPARE(m_portal.readAllCount, 1);
+        QCOMPARE(colorSchemeSpy.count(), 1);
+        QVERIFY(settings.colorScheme() == DesktopPortalSettings::ColorScheme::PreferDark);
+        QVERIFY(settings.accentColor() == QColor::fromRgbF(0.0, 0.5, 1.0));
+    }
+
+    void followsSettingChanged()
+    {
+        DesktopPortalSettings settings(kClientConnection);
+        QSignalSpy initializedSpy(&settings, &DesktopPortalSettings::initialized);
+        QVERIFY(initializedSpy.wait(kSignalTimeout));
+        QSignalSpy colorSchemeSpy(&settings, &DesktopPortalSettings::colorSchemeChanged);
+        m_portal.emitSettingChanged(kColorSchemeKey, uint(2));
+        QVERIFY(colorSchemeSpy.wait(kSignalTimeout));
+        QVERIFY(settings.colorScheme() == DesktopPortalSettings::ColorScheme::PreferLight);
+    }
+
+    void withoutAppearanceSettings()
+    {
+        m_portal.hasAppearance = false;
+        DesktopPortalSettings settings(kClientConnection);
+        QSignalSpy initializedSpy(&settings, &DesktopPortalSettings::initialized);
+        QVERIFY(initializedSpy.wait(kSignalTimeout));
+        QVERIFY(!settings.isAvailable());
+        QVERIFY(!settings.colorScheme().has_value());
+        QVERIFY(!settings.accentColor().has_value());
+    }
+
+    void withoutPortal()
+    {
+        QDBusConnection portalConnection(kPortalConnection);
+        QVERIFY(portalConnection.unregisterService(kPortalService));
+        DesktopPortalSettings settings(kClientConnection);
+        QSignalSpy initializedSpy(&settings, &DesktopPortalSettings::initialized);
+        QVERIFY(initializedSpy.wait(kSignalTimeout));
+        QVERIFY(!settings.isAvailable());
+        QCOMPARE(m_portal.readAllCount, 0);
+        QVERIFY(portalConnection.registerService(kPortalService));
+    }
+
+private:
+    std::unique_ptr<QProcess> m_daemon = nullptr;
+    MockPortal m_portal;
+};
+
+int main(int argc, char *argv[])
+{
+    const auto application = std::make_unique<QCoreApplication>(argc, argv);
+    DesktopPortalTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_portal.moc"
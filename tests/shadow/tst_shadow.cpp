@@ -0,0 +1,257 @@
+/*
+ * MIT License
+ *
+ * Copyright (C) 2021-2023 by wangwenx190 (Yuhang Zhao)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <FramelessHelper/Core/windowshadowpainter.h>
+#include <FramelessHelper/Core/private/windowshadowpainter_p.h>
+#include <FramelessHelper/Core/private/cachebudget_p.h>
+#include <QtGui/qguiapplication.h>
+#include <QtGui/qimage.h>
+#include <QtGui/qpainter.h>
+#include <QtTest/qtest.h>
+#include <algorithm>
+#include <memory>
+#include <tuple>
+
+/*
+ * Checks the nine-slice painting of WindowShadowPainter against its own atlas:
+ * the corners and the edges have to be exact copies of the atlas pieces, whatever
+ * the size of the window, and resizing the window must never build a new atlas.
+ */
+
+FRAMELESSHELPER_USE_NAMESPACE
+
+using AtlasKey = WindowShadowPainterPrivate::AtlasKey;
+
+static constexpr const int kShadowRadius = 16;
+static constexpr const QImage::Format kImageFormat = QImage::Format_ARGB32_Premultiplied;
+
+// The logical size of the corners, the shadow is only uniform along the edges past them.
+[[nodiscard]] static inline int cornerSize(const int cornerRadius)
+{
+    return (kShadowRadius * 2 + cornerRadius);
+}
+
+[[nodiscard]] static inline QImage paintShadow(const WindowShadowPainter &shadow, const QSize &size, const qreal dpr)
+{
+    QImage image(QSizeF(QSizeF(size) * dpr).toSize(), kImageFormat);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    shadow.paint(&painter, size, true);
+    painter.end();
+    return image;
+}
+
+[[nodiscard]] static inline QImage shadowAtlas(const WindowShadowPainter &shadow, const qreal dpr)
+{
+    const AtlasKey key = {shadow.radius(), shadow.cornerRadius(), shadow.activeColor().rgba(), dpr};
+    return WindowShadowPainterPrivate::shadowAtlas(key).convertToFormat(kImageFormat);
+}
+
+// Both rectangles are in device pixels and have the same size.
+[[nodiscard]] static inline bool samePixels(const QImage &lhs, const QRect &lhsRect, const QImage &rhs, const QRect &rhsRect)
+{
+    Q_ASSERT(lhsRect.size() == rhsRect.size());
+    for (int y = 0; y != lhsRect.height(); ++y) {
+        const auto lhsLine = reinterpret_cast<const QRgb *>(lhs.constScanLine(lhsRect.y() + y)) + lhsRect.x();
+        const auto rhsLine = reinterpret_cast<const QRgb *>(rhs.constScanLine(rhsRect.y() + y)) + rhsRect.x();
+        if (!std::equal(lhsLine, lhsLine + lhsRect.width(), rhsLine)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+[[nodiscard]] static inline bool isTransparent(const QImage &image, const QRect &rect)
+{
+    for (int y = rect.top(); y <= rect.bottom(); ++y) {
+        const auto line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = rect.left(); x <= rect.right(); ++x) {
+            if (qAlpha(line[x]) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+class WindowShadowTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowShadowTest(QObject *parent = nullptr) : QObject(parent) {}
+    ~WindowShadowTest() override = default;
+
+private Q_SLOTS:
+    void atlasSize_data()
+    {
+        QTest::addColumn<int>("cornerRadius");
+        QTest::addColumn<qreal>("dpr");
+        QTest::newRow("square@1x") << 0 << qreal(1);
+        QTest::newRow("square@2x") << 0 << qreal(2);
+        QTest::newRow("rounded@1x") << 8 << qreal(1);
+        QTest::newRow("rounded@2x") << 8 << qreal(2);
+    }
+
+    void atlasSize()
+    {
+        QFETCH(int, cornerRadius);
+        QFETCH(qreal, dpr);
+        WindowShadowPainter shadow;
+        shadow.setRadius(kShadowRadius);
+        shadow.setCornerRadius(cornerRadius);
+        // Two corners and the slice in between.
+        const int side = (cornerSize(cornerRadius) * 2 + 1);
+        const QImage atlas = shadowAtlas(shadow, dpr);
+        QCOMPARE(atlas.size(), QSize(qRound(side * dpr), qRound(side * dpr)));
+        // Painting a window of the same size gives back the atlas, nothing more or less.
+        const QImage image = paintShadow(shadow, {side, side}, dpr);
+        QCOMPARE(image.size(), atlas.size());
+        QVERIFY(samePixels(image, image.rect(), atlas, atlas.rect()));
+    }
+
+    void nineSlice_data()
+    {
+        QTest::addColumn<QSize>("size");
+        QTest::addColumn<int>("cornerRadius");
+        QTest::addColumn<qreal>("dpr");
+        for (const int cornerRadius : {0, 8}) {
+            const int smallest = (cornerSize(cornerRadius) * 2);
+            for (const QSize &size : {QSize(smallest, smallest), QSize(200, 120), QSize(641, 479), QSize(1920, 1080)}) {
+                for (const qreal dpr : {qreal(1), qreal(2)}) {
+                    QTest::addRow("%dx%d, corner %d, @%gx", size.width(), size.height(), cornerRadius, dpr)
+                        << size << cornerRadius << dpr;
+                }
+            }
+        }
+    }
+
+    void nineSlice()
+    {
+        QFETCH(QSize, size);
+        QFETCH(int, cornerRadius);
+        QFETCH(qreal, dpr);
+        WindowShadowPainter shadow;
+        shadow.setRadius(kShadowRadius);
+        shadow.setCornerRadius(cornerRadius);
+        const QImage atlas = shadowAtlas(shadow, dpr);
+        const QImage image = paintShadow(shadow, size, dpr);
+        // Everything below is in device pixels.
+        const int corner = qRound(cornerSize(cornerRadius) * dpr);
+        const int slice = qRound(dpr);
+        const int full = atlas.width();
+        const int width = image.width();
+        const int height = image.height();
+        QVERIFY(samePixels(image, {0, 0, corner, corner}, atlas, {0, 0, corner, corner}));
+        QVERIFY(samePixels(image, {width - corner, 0, corner, corner}, atlas, {full - corner, 0, corner, corner}));
+        QVERIFY(samePixels(image, {0, height - corner, corner, corner}, atlas, {0, full - corner, corner, corner}));
+        QVERIFY(samePixels(image, {width - corner, height - corner, corner, corner},
+            atlas, {full - corner, full - corner, corner, corner}));
+        // Each line of the edges is one of the lines of the slice, nothing is interpolated.
+        const auto isSliceColumn = [&](const int x, const int y) -> bool {
+            for (int i = 0; i != slice; ++i) {
+                if (samePixels(image, {x, y, 1, corner}, atlas, {corner + i, ((y > 0) ? (full - corner) : 0), 1, corner})) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        const auto isSliceRow = [&](const int x, const int y) -> bool {
+            for (int i = 0; i != slice; ++i) {
+                if (samePixels(image, {x, y, corner, 1}, atlas, {((x > 0) ? (full - corner) : 0), corner + i, corner, 1})) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        for (int x = corner; x < (width - corner); ++x) {
+            QVERIFY2(isSliceColumn(x, 0), qPrintable(QStringLiteral("top edge, x = %1").arg(x)));
+            QVERIFY2(isSliceColumn(x, height - corner), qPrintable(QStringLiteral("bottom edge, x = %1").arg(x)));
+        }
+        for (int y = corner; y < (height - corner); ++y) {
+            QVERIFY2(isSliceRow(0, y), qPrintable(QStringLiteral("left edge, y = %1").arg(y)));
+            QVERIFY2(isSliceRow(width - corner, y), qPrintable(QStringLiteral("right edge, y = %1").arg(y)));
+        }
+        // The window covers the rest, it's left alone.
+        const QRect inner = {corner, corner, width - (corner * 2), height - (corner * 2)};
+        if (!inner.isEmpty()) {
+            QVERIFY(isTransparent(image, inner));
+        }
+    }
+
+    void tooSmall()
+    {
+        WindowShadowPainter shadow;
+        shadow.setRadius(kShadowRadius);
+        const int smallest = (cornerSize(0) * 2);
+        for (const QSize &size : {QSize(smallest - 1, 400), QSize(400, smallest - 1)}) {
+            const QImage image = paintShadow(shadow, size, 1);
+            QVERIFY(isTransparent(image, image.rect()));
+        }
+    }
+
+    void atlasReuse()
+    {
+        WindowShadowPainter shadow;
+        shadow.setRadius(kShadowRadius);
+        shadow.setCornerRadius(8);
+        // Not used by anything else here, so the atlas is built by this test only.
+        shadow.setActiveColor(QColor(255, 0, 0, 90));
+        CacheBudget * const budget = CacheBudget::instance();
+        const qint64 initialUsage = budget->usage(CacheBudget::Cache::Shadows);
+        std::ignore = paintShadow(shadow, {200, 200}, 1);
+        const qint64 usage = budget->usage(CacheBudget::Cache::Shadows);
+        QVERIFY(usage > initialUsage);
+        const AtlasKey key = {shadow.radius(), shadow.cornerRadius(), shadow.activeColor().rgba(), 1};
+        const qint64 cacheKey = WindowShadowPainterPrivate::shadowAtlas(key).cacheKey();
+        // One atlas per key, however the window is resized.
+        for (const QSize &size : {QSize(201, 200), QSize(640, 480), QSize(1920, 1080), QSize(333, 4000), QSize(200, 200)}) {
+            std::ignore = paintShadow(shadow, size, 1);
+            QCOMPARE(budget->usage(CacheBudget::Cache::Shadows), usage);
+            QCOMPARE(WindowShadowPainterPrivate::shadowAtlas(key).cacheKey(), cacheKey);
+        }
+        // A different device pixel ratio needs one of its own, but doesn't replace the first one.
+        std::ignore = paintShadow(shadow, {200, 200}, 2);
+        QVERIFY(budget->usage(CacheBudget::Cache::Shadows) > usage);
+        const AtlasKey hiDpiKey = {shadow.radius(), shadow.cornerRadius(), shadow.activeColor().rgba(), 2};
+        QVERIFY(WindowShadowPainterPrivate::shadowAtlas(hiDpiKey).cacheKey() != cacheKey);
+        QCOMPARE(WindowShadowPainterPrivate::shadowAtlas(key).cacheKey(), cacheKey);
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    const QByteArray platform = (qEnvironmentVariableIsSet("QT_QPA_PLATFORM") ?
+        qgetenv("QT_QPA_PLATFORM") : FRAMELESSHELPER_BYTEARRAY_LITERAL("offscreen"));
+    FramelessHelper::Core::initialize();
+    // initialize() forces the xcb plugin on Linux, which needs a display server.
+    qputenv("QT_QPA_PLATFORM", platform);
+    const auto application = std::make_unique<QGuiApplication>(argc, argv);
+    WindowShadowTest test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_shadow.moc"